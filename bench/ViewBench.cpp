@@ -0,0 +1,142 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+/*
+ * Micro-benchmark for the view representation: compares View::update()
+ * and View::leq() against the IndexedMap-based View they replaced (with
+ * its entry-by-entry join, and an entry-by-entry inclusion check), for
+ * views of various sizes (i.e., numbers of threads).
+ *
+ * Usage: view-bench [iterations]
+ */
+
+#include "ADT/View.hpp"
+#include "ADT/ViewKernels.hpp"
+
+#include <llvm/ADT/IndexedMap.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+/* The previous View: its entries, update() and getMax()/setMax() are
+ * copied verbatim; leq() compares entry by entry in the same way */
+class BaselineView {
+public:
+	[[nodiscard]] auto size() const -> unsigned int { return view_.size(); }
+
+	[[nodiscard]] auto empty() const -> bool { return size() == 0; }
+
+	auto update(const BaselineView &v) -> BaselineView &
+	{
+		if (v.empty())
+			return *this;
+
+		auto size = std::max(this->size(), v.size());
+		for (auto i = 0U; i < size; i++)
+			if (getMax(i) < v.getMax(i))
+				setMax(Event(i, v.getMax(i)));
+		return *this;
+	}
+
+	[[nodiscard]] auto leq(const BaselineView &v) const -> bool
+	{
+		auto size = std::max(this->size(), v.size());
+		for (auto i = 0U; i < size; i++)
+			if (getMax(i) > v.getMax(i))
+				return false;
+		return true;
+	}
+
+	[[nodiscard]] auto getMax(int thread) const -> int
+	{
+		if (thread < (int)view_.size())
+			return view_[thread];
+		return 0;
+	}
+
+	void setMax(Event e)
+	{
+		if (e.thread >= (int)view_.size())
+			view_.grow(e.thread);
+		view_[e.thread] = e.index;
+	}
+
+private:
+	llvm::IndexedMap<int> view_{0};
+};
+
+/* Returns COUNT random views of each kind with the same entries */
+auto randomViews(unsigned int count, unsigned int size, std::mt19937 &rng)
+	-> std::pair<std::vector<BaselineView>, std::vector<View>>
+{
+	std::uniform_int_distribution<int> dist(0, 1000);
+	std::vector<BaselineView> old(count);
+	std::vector<View> views(count);
+	for (auto j = 0U; j < count; j++) {
+		for (auto i = 0U; i < size; i++) {
+			auto e = Event(i, dist(rng));
+			old[j].setMax(e);
+			views[j].setMax(e);
+		}
+	}
+	return {std::move(old), std::move(views)};
+}
+
+template <typename F> auto timeNs(unsigned long iters, F &&fun) -> double
+{
+	auto start = std::chrono::steady_clock::now();
+	for (auto i = 0UL; i < iters; i++)
+		fun(i);
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / iters;
+}
+
+} // namespace
+
+auto main(int argc, char **argv) -> int
+{
+	auto iters = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000UL;
+	constexpr unsigned int numViews = 64;
+	std::mt19937 rng(42);
+
+	std::printf("%8s %14s %14s %14s %14s\n", "threads", "update (old)", "update (new)",
+		    "leq (old)", "leq (new)");
+	for (auto size : {2U, 3U, 4U, 5U, 6U, 8U, 12U, 16U, 32U, 64U}) {
+		auto [oldSrcs, srcs] = randomViews(numViews, size, rng);
+		auto [oldDsts, dsts] = randomViews(numViews, size, rng);
+		auto sink = 0U;
+
+		/* Both kinds of views hold the same entries throughout */
+		auto updOld = timeNs(iters, [&](auto i) {
+			oldDsts[i % numViews].update(oldSrcs[(i * 7) % numViews]);
+		});
+		auto updNew = timeNs(iters, [&](auto i) {
+			dsts[i % numViews].update(srcs[(i * 7) % numViews]);
+		});
+		auto leqOld = timeNs(iters, [&](auto i) {
+			sink += oldSrcs[i % numViews].leq(oldDsts[(i * 7) % numViews]);
+		});
+		auto leqNew = timeNs(iters, [&](auto i) {
+			sink += srcs[i % numViews].leq(dsts[(i * 7) % numViews]);
+		});
+		std::printf("%8u %12.2fns %12.2fns %12.2fns %12.2fns%s\n", size, updOld, updNew,
+			    leqOld, leqNew, sink == ~0U ? " " : "");
+	}
+	return 0;
+}
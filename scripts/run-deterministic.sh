@@ -0,0 +1,54 @@
+#!/bin/bash
+
+# Runs the (fast) test suite twice under the deterministic parallel policy,
+# and checks that both runs report the same errors and execution counts
+#
+# This program is dual-licensed under the Apache License 2.0 and the MIT License.
+# You may choose to use, distribute, or modify this software under either license.
+#
+# Apache License 2.0:
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# MIT License:
+#     https://opensource.org/licenses/MIT
+
+DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" >/dev/null 2>&1 && pwd )"
+GenMC="${GenMC:-$DIR/../RelWithDebInfo/genmc}"
+source "${DIR}/terminal.sh"
+
+threads="${threads:-4}"
+
+logdir=$(mktemp -d)
+trap 'rm -rf "${logdir}"' EXIT
+
+# Wrap GenMC so that the output of each test is also logged
+# (apart from the timing and the work-sharing statistics, which vary across runs)
+cat > "${logdir}/genmc" <<EOF
+#!/bin/bash
+output=\$("${GenMC}" "\$@" 2>&1)
+status=\$?
+echo "\${output}"
+{ echo "=== \$* (status: \${status})"; echo "\${output}" | awk '!/Total wall-clock time|Number of (parallel|distributed) tasks|tasks stolen across NUMA|^(Thread|Worker) [0-9]+: /'; } >> "\${GENMC_LOG}"
+exit \${status}
+EOF
+chmod +x "${logdir}/genmc"
+
+# Estimation samples executions randomly, so it is not reproducible
+detflags="--nthreads=${threads} -parallel-policy=deterministic --disable-estimation"
+for run in 1 2
+do
+    GenMC="${logdir}/genmc" GENMC_LOG="${logdir}/run${run}.log" \
+	 GENMCFLAGS="${GENMCFLAGS} ${detflags}" WRONGFLAGS="${WRONGFLAGS} ${detflags}" \
+	 "${DIR}/driver.sh" --fast || exit 1
+done
+
+if ! diff -u "${logdir}/run1.log" "${logdir}/run2.log"
+then
+    echo ''; printline
+    echo '!!! ' DETERMINISTIC RUNS DIFFER ' !!!'
+    printline
+    exit 1
+fi
+echo ''; printline
+echo '--- ' Deterministic runs produced identical results.
+printline
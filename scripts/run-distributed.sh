@@ -0,0 +1,60 @@
+#!/bin/bash
+
+# Runs the (fast) test suite with the exploration distributed to worker processes.
+# With --inject-faults (which needs a debug build of GenMC), runs it again with
+# a worker exiting early (which must not affect the results), and checks that
+# a worker crashing in the middle of a task fails the run
+#
+# This program is dual-licensed under the Apache License 2.0 and the MIT License.
+# You may choose to use, distribute, or modify this software under either license.
+#
+# Apache License 2.0:
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# MIT License:
+#     https://opensource.org/licenses/MIT
+
+DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" >/dev/null 2>&1 && pwd )"
+GenMC="${GenMC:-$DIR/../RelWithDebInfo/genmc}"
+source "${DIR}/terminal.sh"
+
+workers="${workers:-2}"
+faults=""
+if test "$1" = "--inject-faults"
+then
+    faults="yes"
+fi
+
+distflags="--distributed-workers=${workers}"
+runs=("${distflags}")
+if test -n "${faults}"
+then
+    runs+=("${distflags} --distributed-exit-after=1")
+fi
+for flags in "${runs[@]}"
+do
+    GENMCFLAGS="${GENMCFLAGS} ${flags}" WRONGFLAGS="${WRONGFLAGS} ${flags}" \
+	      "${DIR}/driver.sh" --fast || exit 1
+done
+
+if test -z "${faults}"
+then
+    exit 0
+fi
+
+# The first worker crashes after handing some of its executions to others,
+# so the rest of them cannot be explored again: the run must not succeed
+test="${DIR}/../tests/correct/synthetic/big0/variants/big00.c"
+output=$("${GenMC}" ${GENMCFLAGS} -rc11 -disable-mm-detector ${distflags} \
+		    --distributed-crash-after=1 -- "${test}" 2>&1)
+if test "$?" -eq 0 || ! echo "${output}" | grep -q "exploration would be incomplete"
+then
+    echo "${output}"
+    echo ''; printline
+    echo '!!! ' A CRASHED WORKER WENT UNNOTICED ' !!!'
+    printline
+    exit 1
+fi
+echo ''; printline
+echo '--- ' A crashed worker failed the run as expected.
+printline
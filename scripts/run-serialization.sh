@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# Runs the (fast) test suite checking that graphs survive saving and loading
+# (requires a debug build)
+#
+# This program is dual-licensed under the Apache License 2.0 and the MIT License.
+# You may choose to use, distribute, or modify this software under either license.
+#
+# Apache License 2.0:
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# MIT License:
+#     https://opensource.org/licenses/MIT
+
+DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" >/dev/null 2>&1 && pwd )"
+source "${DIR}/terminal.sh"
+
+GENMCFLAGS="${GENMCFLAGS} --check-graph-serialization" "${DIR}/driver.sh" --fast
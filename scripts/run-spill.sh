@@ -0,0 +1,26 @@
+#!/bin/bash
+
+# Runs the (fast) test suite keeping only the top entry of the execution
+# stack in memory, both sequentially and in parallel (where spilled entries
+# can be donated to other threads)
+#
+# This program is dual-licensed under the Apache License 2.0 and the MIT License.
+# You may choose to use, distribute, or modify this software under either license.
+#
+# Apache License 2.0:
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# MIT License:
+#     https://opensource.org/licenses/MIT
+
+DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" >/dev/null 2>&1 && pwd )"
+source "${DIR}/terminal.sh"
+
+threads="${threads:-2}"
+
+spillflags="--spill-exec-stack=1"
+for flags in "${spillflags}" "${spillflags} --nthreads=${threads}"
+do
+    GENMCFLAGS="${GENMCFLAGS} ${flags}" WRONGFLAGS="${WRONGFLAGS} ${flags}" \
+	      "${DIR}/driver.sh" --fast || exit 1
+done
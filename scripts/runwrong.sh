@@ -19,6 +19,7 @@ source "${DIR}/terminal.sh"
 model="${model:-rc11}"
 coherence="${coherence:-wb}"
 suppress_diff="${suppress_diff:-}"
+WRONGFLAGS="${WRONGFLAGS:-}" # extra flags (GENMCFLAGS are not used here)
 
 runtime=0
 tests_success=0
@@ -153,7 +154,7 @@ runvariants() {
     for t in $dir/variants/*.c $dir/variants/*.cpp
     do
 	vars=$((vars+1))
-	output=`"${GenMC}" "-${model}" -disable-estimation -disable-mm-detector "${unroll}" -print-error-trace $(echo ${checker_args[@]}) -- ${CFLAGS} ${test_args} ${t} 2>&1`
+	output=`"${GenMC}" "-${model}" -disable-estimation -disable-mm-detector "${unroll}" -print-error-trace ${WRONGFLAGS} $(echo ${checker_args[@]}) -- ${CFLAGS} ${test_args} ${t} 2>&1`
 	status="$?"
 	diff_file="${t%.*}.${model}.${coherence}.trace" &&
 	    [[ -f "${t%.*}.${model}.${coherence}.trace-${LLVM_VERSION}" ]] &&
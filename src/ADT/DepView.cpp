@@ -28,8 +28,8 @@ void DepView::addHole(const Event e)
 
 void DepView::addHolesInRange(Event start, int endIdx)
 {
-	for (auto i = start.index; i < endIdx; i++)
-		addHole(Event(start.thread, i));
+	BUG_ON(endIdx - 1 > getMax(start.thread));
+	holes_[start.thread].insert(start.index, endIdx);
 }
 
 void DepView::removeHole(const Event e) { holes_[e.thread].erase(e.index); }
@@ -38,8 +38,7 @@ void DepView::removeAllHoles(int thread) { holes_[thread].clear(); }
 
 void DepView::removeHolesInRange(Event start, int endIdx)
 {
-	for (auto i = start.index; i < endIdx; i++)
-		removeHole(Event(start.thread, i));
+	holes_[start.thread].erase(start.index, endIdx);
 }
 
 auto DepView::update(const View &v) -> View & { BUG(); }
@@ -52,14 +51,10 @@ auto DepView::update(const DepView &v) -> DepView &
 	for (auto i = 0U; i < v.size(); i++) {
 		auto isec = holes_[i].intersectWith(v.holes_[i]);
 		if (getMax(i) < v.getMax(i)) {
-			isec.insert(std::lower_bound(v.holes_[i].begin(), v.holes_[i].end(),
-						     getMax(i) + 1),
-				    v.holes_[i].end());
+			isec.insertFrom(v.holes_[i], getMax(i) + 1);
 			view_.setMax(Event(i, v.getMax(i)));
 		} else {
-			isec.insert(std::lower_bound(holes_[i].begin(), holes_[i].end(),
-						     v.getMax(i) + 1),
-				    holes_[i].end());
+			isec.insertFrom(holes_[i], v.getMax(i) + 1);
 		}
 		holes_[i] = std::move(isec);
 	}
@@ -77,10 +72,7 @@ void DepView::printData(llvm::raw_ostream &s) const
 {
 	s << "[\n";
 	for (auto i = 0U; i < size(); i++) {
-		s << "\t" << i << ": " << getMax(i) << " ( ";
-		for (const auto &h : this->holes_[i])
-			s << h << " ";
-		s << ")\n";
+		s << "\t" << i << ": " << getMax(i) << " " << this->holes_[i] << "\n";
 	}
 
 	s << "]";
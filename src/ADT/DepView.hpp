@@ -14,11 +14,11 @@
 #ifndef GENMC_DEP_VIEW_HPP
 #define GENMC_DEP_VIEW_HPP
 
-#include "ADT/VSet.hpp"
+#include "ADT/IntervalSet.hpp"
 #include "ADT/VectorClock.hpp"
 #include "ADT/View.hpp"
 #include "Support/Error.hpp"
-#include <llvm/ADT/IndexedMap.h>
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/Support/raw_ostream.h>
 
 /**
@@ -28,13 +28,15 @@
  */
 class DepView : public VectorClock {
 private:
-	using Holes = VSet<int>;
+	using Holes = IntervalSet<int>;
 
+	/* Like View, keeps the holes of a few threads inline */
 	class HoleView {
-		llvm::IndexedMap<Holes> hs_;
+		static constexpr unsigned int inlineHoles = 8;
+		llvm::SmallVector<Holes, inlineHoles> hs_;
 
 	public:
-		HoleView() : hs_(Holes()) {}
+		HoleView() = default;
 
 		[[nodiscard]] auto size() const -> unsigned int { return hs_.size(); }
 
@@ -49,9 +51,18 @@ private:
 
 		auto operator[](int idx) -> Holes &
 		{
-			hs_.grow(idx);
+			if (idx >= (int)hs_.size())
+				hs_.resize(idx + 1);
 			return hs_[idx];
 		}
+
+		[[nodiscard]] auto getHeapSize() const -> size_t
+		{
+			auto size = hs_.capacity() > inlineHoles ? hs_.capacity() * sizeof(Holes) : 0;
+			for (const auto &h : hs_)
+				size += h.getHeapSize();
+			return size;
+		}
 	};
 
 public:
@@ -105,6 +116,13 @@ public:
 		return e.thread < holes_.size() && !holes_[e.thread].count(e.index);
 	}
 
+	/** Returns the indices of THREAD that have not been seen (as intervals) */
+	[[nodiscard]] auto getHoles(int thread) const -> const Holes &
+	{
+		static const Holes noHoles;
+		return thread < holes_.size() ? holes_[thread] : noHoles;
+	}
+
 	/** Records that the event in the index of e has not been
 	 * seen in the respective thread */
 	void addHole(Event e);
@@ -127,6 +145,12 @@ public:
 	auto update(const DepView &v) -> DepView & override;
 	auto update(const VectorClock &vc) -> VectorClock & override;
 
+	[[nodiscard]] auto getFootprint() const -> size_t override
+	{
+		/* view_ is part of the DepView; only count what it allocated */
+		return sizeof(DepView) + (view_.getFootprint() - sizeof(View)) + holes_.getHeapSize();
+	}
+
 	void printData(llvm::raw_ostream &s) const override;
 
 	static auto classof(const VectorClock *vc) -> bool { return vc->getKind() == VC_DepView; }
@@ -0,0 +1,200 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#ifndef GENMC_INTERVAL_SET_HPP
+#define GENMC_INTERVAL_SET_HPP
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+
+/**
+ * A set of integral values, represented as a sorted vector of disjoint,
+ * non-adjacent, half-open intervals. Point and range queries take
+ * logarithmic time in the number of intervals; ranges of consecutive
+ * elements are inserted and erased without touching each element.
+ */
+template <class T> class IntervalSet {
+
+public:
+	/** The interval [lo, hi) */
+	struct Interval {
+		T lo;
+		T hi;
+
+		auto operator<=>(const Interval &other) const = default;
+	};
+
+	static constexpr unsigned int inlineIntervals = 2;
+	using Intervals = llvm::SmallVector<Interval, inlineIntervals>;
+	using const_iterator = typename Intervals::const_iterator;
+
+	IntervalSet() = default;
+
+	/** Iterates over the intervals of the set (in increasing order) */
+	auto begin() const -> const_iterator { return ivs_.begin(); };
+	auto end() const -> const_iterator { return ivs_.end(); };
+
+	/** Inserts EL in the set */
+	void insert(const T &el) { insert(el, el + 1); }
+
+	/** Inserts all elements in [LO, HI) in the set */
+	void insert(const T &lo, const T &hi);
+
+	/** Inserts all elements of S that are greater or equal to FROM */
+	void insertFrom(const IntervalSet<T> &s, const T &from);
+
+	/** Erases EL from the set */
+	void erase(const T &el) { erase(el, el + 1); }
+
+	/** Erases all elements in [LO, HI) from the set */
+	void erase(const T &lo, const T &hi);
+
+	/** Return the number of elements in the set */
+	auto count(const T &el) const -> int { return contains(el) ? 1 : 0; }
+
+	/** Returns whether the set contains EL */
+	auto contains(const T &el) const -> bool;
+
+	/** Returns the intersection of `THIS` and `S` */
+	auto intersectWith(const IntervalSet<T> &s) const -> IntervalSet<T>;
+
+	/** Returns the number of intervals in the set */
+	[[nodiscard]] auto numIntervals() const -> size_t { return ivs_.size(); }
+
+	/** Returns whether the set empty */
+	[[nodiscard]] auto empty() const -> bool { return ivs_.empty(); };
+
+	/** Empties the set */
+	void clear() { ivs_.clear(); };
+
+	/** Returns the bytes the set has allocated on the heap */
+	[[nodiscard]] auto getHeapSize() const -> size_t
+	{
+		return ivs_.capacity() > inlineIntervals ? ivs_.capacity() * sizeof(Interval) : 0;
+	}
+
+	auto operator==(const IntervalSet<T> &other) const -> bool { return ivs_ == other.ivs_; }
+
+	template <typename U>
+	friend auto operator<<(llvm::raw_ostream &s, const IntervalSet<U> &set)
+		-> llvm::raw_ostream &;
+
+private:
+	/** Returns the first interval that ends after EL */
+	auto firstEndingAfter(const T &el) const -> const_iterator
+	{
+		return std::partition_point(begin(), end(),
+					    [&](const Interval &iv) { return iv.hi <= el; });
+	}
+
+	Intervals ivs_;
+};
+
+/**** IntervalSet templates ****/
+
+template <typename T> void IntervalSet<T>::insert(const T &lo, const T &hi)
+{
+	if (lo >= hi)
+		return;
+
+	/* Common case: appending to the end of the set */
+	if (empty() || ivs_.back().hi < lo) {
+		ivs_.push_back({lo, hi});
+		return;
+	}
+
+	/* Merge all intervals that overlap with (or are adjacent to) [lo, hi) */
+	auto first = std::partition_point(ivs_.begin(), ivs_.end(),
+					  [&](const Interval &iv) { return iv.hi < lo; });
+	auto last = std::partition_point(first, ivs_.end(),
+					 [&](const Interval &iv) { return iv.lo <= hi; });
+	if (first == last) {
+		ivs_.insert(first, {lo, hi});
+		return;
+	}
+	first->lo = std::min(first->lo, lo);
+	first->hi = std::max(std::prev(last)->hi, hi);
+	ivs_.erase(std::next(first), last);
+}
+
+template <typename T> void IntervalSet<T>::insertFrom(const IntervalSet<T> &s, const T &from)
+{
+	for (auto it = s.firstEndingAfter(from); it != s.end(); ++it)
+		insert(std::max(it->lo, from), it->hi);
+}
+
+template <typename T> void IntervalSet<T>::erase(const T &lo, const T &hi)
+{
+	if (lo >= hi)
+		return;
+
+	auto first = std::partition_point(ivs_.begin(), ivs_.end(),
+					  [&](const Interval &iv) { return iv.hi <= lo; });
+	auto last = std::partition_point(first, ivs_.end(),
+					 [&](const Interval &iv) { return iv.lo < hi; });
+	if (first == last)
+		return;
+
+	/* Keep the parts of the boundary intervals that lie outside [lo, hi) */
+	auto leftLo = first->lo;
+	auto rightHi = std::prev(last)->hi;
+	auto pos = ivs_.erase(first, last);
+	if (hi < rightHi)
+		pos = ivs_.insert(pos, {hi, rightHi});
+	if (leftLo < lo)
+		ivs_.insert(pos, {leftLo, lo});
+}
+
+template <typename T> auto IntervalSet<T>::contains(const T &el) const -> bool
+{
+	auto it = firstEndingAfter(el);
+	return it != end() && it->lo <= el;
+}
+
+template <typename T>
+auto IntervalSet<T>::intersectWith(const IntervalSet<T> &s) const -> IntervalSet<T>
+{
+	IntervalSet<T> result;
+
+	auto a = begin();
+	auto b = s.begin();
+	while (a != end() && b != s.end()) {
+		auto lo = std::max(a->lo, b->lo);
+		auto hi = std::min(a->hi, b->hi);
+		if (lo < hi)
+			result.ivs_.push_back({lo, hi});
+		if (a->hi < b->hi)
+			++a;
+		else
+			++b;
+	}
+	return result;
+}
+
+template <typename T>
+auto operator<<(llvm::raw_ostream &s, const IntervalSet<T> &set) -> llvm::raw_ostream &
+{
+	s << "[ ";
+	for (const auto &iv : set) {
+		if (iv.hi - iv.lo == 1)
+			s << iv.lo << " ";
+		else
+			s << iv.lo << "-" << iv.hi - 1 << " ";
+	}
+	s << "]";
+	return s;
+}
+
+#endif /* GENMC_INTERVAL_SET_HPP */
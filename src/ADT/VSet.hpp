@@ -78,6 +78,9 @@ public:
 	/** Empties the set */
 	void clear() { vset_.clear(); };
 
+	/** Returns the bytes the set has allocated on the heap */
+	[[nodiscard]] auto getHeapSize() const -> size_t { return vset_.capacity() * sizeof(T); }
+
 	/** Returns whether `THIS` is a subset of `S` */
 	auto subsetOf(const VSet<T> &s) const -> bool;
 
@@ -15,6 +15,7 @@
 #include "ADT/DepView.hpp"
 #include "ADT/View.hpp"
 #include "ExecutionGraph/EventLabel.hpp"
+#include "Support/Serialization.hpp"
 
 auto VectorClock::contains(const EventLabel *lab) const -> bool { return contains(lab->getPos()); }
 
@@ -29,6 +30,48 @@ auto VectorClock::clone() const -> std::unique_ptr<VectorClock>
 	BUG();
 }
 
+void VectorClock::serialize(ByteWriter &out) const
+{
+	out.writeEnum(getKind());
+	out.writeU64(size());
+	for (auto i = 0U; i < size(); i++) {
+		out.writeS64(getMax(i));
+		if (const auto *dv = llvm::dyn_cast<DepView>(this)) {
+			const auto &holes = dv->getHoles(i);
+			out.writeU64(holes.numIntervals());
+			for (const auto &h : holes) {
+				out.writeS64(h.lo);
+				out.writeS64(h.hi);
+			}
+		}
+	}
+}
+
+auto VectorClock::deserialize(ByteReader &in) -> std::unique_ptr<VectorClock>
+{
+	auto kind = in.readEnum<VectorClockKind>();
+	ERROR_ON(kind != VC_View && kind != VC_DepView, "Malformed serialized vector clock!\n");
+
+	std::unique_ptr<VectorClock> vc;
+	if (kind == VC_View)
+		vc = std::make_unique<View>();
+	else
+		vc = std::make_unique<DepView>();
+
+	auto size = in.readU64();
+	for (auto i = 0U; i < size; i++) {
+		vc->setMax(Event(i, in.readS64()));
+		if (auto *dv = llvm::dyn_cast<DepView>(&*vc)) {
+			dv->removeAllHoles(i);
+			for (auto j = in.readU64(); j > 0; j--) {
+				auto lo = in.readS64();
+				dv->addHolesInRange(Event(i, lo), in.readS64());
+			}
+		}
+	}
+	return vc;
+}
+
 auto operator<<(llvm::raw_ostream &s, const VectorClock &vc) -> llvm::raw_ostream &
 {
 	vc.printData(s);
@@ -24,6 +24,8 @@
 class View;
 class DepView;
 class EventLabel;
+class ByteWriter;
+class ByteReader;
 
 /**
  * An abstract class for modeling vector clocks. Contains the bare
@@ -80,9 +82,17 @@ public:
 
 	virtual void setMax(Event e) = 0;
 
+	/** Returns the size of the clock in bytes (including its heap-allocated
+	 * entries; used for memory accounting) */
+	[[nodiscard]] virtual auto getFootprint() const -> size_t = 0;
+
 	/** Clones a VectorClock */
 	[[nodiscard]] auto clone() const -> std::unique_ptr<VectorClock>;
 
+	/** Serialization facilities (see Support/Serialization.hpp) */
+	void serialize(ByteWriter &out) const;
+	static auto deserialize(ByteReader &in) -> std::unique_ptr<VectorClock>;
+
 	/** Printing facilities */
 	virtual void printData(llvm::raw_ostream &s) const = 0;
 	friend auto operator<<(llvm::raw_ostream &s, const VectorClock &v) -> llvm::raw_ostream &;
@@ -12,6 +12,7 @@
  */
 
 #include "ADT/View.hpp"
+#include "ADT/ViewKernels.hpp"
 #include "Support/Error.hpp"
 
 auto View::size() const -> unsigned int { return view_.size(); }
@@ -25,13 +26,27 @@ auto View::update(const View &v) -> View &
 	if (v.empty())
 		return *this;
 
-	auto size = std::max(this->size(), v.size());
-	for (auto i = 0U; i < size; i++)
-		if (getMax(i) < v.getMax(i))
-			setMax(Event(i, v.getMax(i)));
+	if (size() < v.size())
+		view_.resize(v.size());
+	ViewKernels::join(begin(), v.begin(), v.size());
 	return *this;
 }
 
+/* Entries past the end of a view are 0, so the excess entries
+ * of one view are compared against 0 */
+static auto leqEntries(const int *a, unsigned int aSize, const int *b, unsigned int bSize) -> bool
+{
+	auto n = std::min(aSize, bSize);
+	return ViewKernels::leq(a, b, n) && std::all_of(a + n, a + aSize, [](int x) {
+		       return x <= 0;
+	       }) && std::all_of(b + n, b + bSize, [](int x) { return x >= 0; });
+}
+
+auto View::leq(const View &v) const -> bool
+{
+	return leqEntries(begin(), size(), v.begin(), v.size());
+}
+
 auto View::update(const DepView &v) -> DepView & { BUG(); }
 
 auto View::update(const VectorClock &vc) -> VectorClock &
@@ -16,34 +16,47 @@
 
 #include "ADT/VectorClock.hpp"
 #include "ExecutionGraph/Event.hpp"
-#include <llvm/ADT/IndexedMap.h>
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/Support/raw_ostream.h>
 
 /**
  * An instantiation of a vector clock where it is assumed that if an index
  * is contained in the clock, all of its po-predecessors are also contained
  * in the clock.
+ * The entries of up to inlineThreads threads are stored inline, so that
+ * views of most programs do not need heap allocations. Views are 32-byte
+ * aligned, which places the inline entries (that follow the vtable pointer,
+ * the kind, and the SmallVector header) on a 32-byte boundary: vector loads
+ * of them never straddle cache lines (see ViewKernels).
  */
-class View : public VectorClock {
+class alignas(32) View final : public VectorClock {
+public:
+	static constexpr unsigned int inlineThreads = 16;
+
 private:
-	using EventView = llvm::IndexedMap<int>;
+	using EventView = llvm::SmallVector<int, inlineThreads>;
 	EventView view_;
 
 public:
 	/** Constructors */
-	View() : VectorClock(VectorClock::VectorClockKind::VC_View), view_(EventView(0)) {}
+	View() : VectorClock(VectorClock::VectorClockKind::VC_View) {}
+	View(const View &) = default;
+	View(View &&other) noexcept : VectorClock(other), view_(std::move(other.view_)) {}
+	auto operator=(const View &) -> View & = default;
+	auto operator=(View &&other) noexcept -> View &
+	{
+		view_ = std::move(other.view_);
+		return *this;
+	}
 
 	/** Iterators */
 	using iterator = int *;
 	using const_iterator = const int *;
 
-	auto begin() -> iterator { return &view_[0]; };
-	auto end() -> iterator { return &view_[0] + size(); }
-	[[nodiscard]] auto begin() const -> const_iterator { return empty() ? nullptr : &view_[0]; }
-	[[nodiscard]] auto end() const -> const_iterator
-	{
-		return empty() ? nullptr : &view_[0] + size();
-	}
+	auto begin() -> iterator { return view_.begin(); };
+	auto end() -> iterator { return view_.end(); }
+	[[nodiscard]] auto begin() const -> const_iterator { return view_.begin(); }
+	[[nodiscard]] auto end() const -> const_iterator { return view_.end(); }
 
 	/** Returns the size of this view (i.e., number of threads seen) */
 	[[nodiscard]] auto size() const -> unsigned int override;
@@ -63,6 +76,10 @@ public:
 	auto update(const DepView &dv) -> DepView & override;
 	auto update(const VectorClock &vc) -> VectorClock & override;
 
+	/** Returns true if each entry of this view is at most
+	 * the respective entry of V */
+	[[nodiscard]] auto leq(const View &v) const -> bool;
+
 	/** Makes the maximum event seen in e's thread equal to e */
 	auto updateIdx(Event e) -> View & override
 	{
@@ -81,10 +98,16 @@ public:
 	void setMax(Event e) override
 	{
 		if (e.thread >= (int)view_.size())
-			view_.grow(e.thread);
+			view_.resize(e.thread + 1);
 		view_[e.thread] = e.index;
 	}
 
+	[[nodiscard]] auto getFootprint() const -> size_t override
+	{
+		auto heap = view_.capacity() > inlineThreads ? view_.capacity() * sizeof(int) : 0;
+		return sizeof(View) + heap;
+	}
+
 	void printData(llvm::raw_ostream &s) const override;
 
 	static auto classof(const VectorClock *vc) -> bool { return vc->getKind() == VC_View; }
@@ -0,0 +1,128 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#include "ADT/ViewKernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GENMC_VIEW_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace ViewKernels {
+
+#ifdef GENMC_VIEW_KERNELS_X86
+
+/* The inline entries of views are 32-byte aligned (see View), but entries
+ * that spilled to the heap need not be, so unaligned loads/stores are used
+ * throughout. (On aligned addresses, these are as fast as aligned ones.)
+ * The AVX2 variants handle a remaining block of 4 entries with SSE, so that
+ * views of 4-7 threads do not fall back to scalar loops */
+
+__attribute__((target("avx2"))) static void joinAVX2(int *dst, const int *src, unsigned int n)
+{
+	auto i = 0U;
+	for (; i + 8 <= n; i += 8) {
+		auto *d = reinterpret_cast<__m256i *>(dst + i);
+		auto s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+		_mm256_storeu_si256(d, _mm256_max_epi32(_mm256_loadu_si256(d), s));
+	}
+	if (i + 4 <= n) {
+		auto *d = reinterpret_cast<__m128i *>(dst + i);
+		auto s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+		_mm_storeu_si128(d, _mm_max_epi32(_mm_loadu_si128(d), s));
+		i += 4;
+	}
+	joinScalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2"))) static auto leqAVX2(const int *a, const int *b, unsigned int n)
+	-> bool
+{
+	auto i = 0U;
+	for (; i + 8 <= n; i += 8) {
+		auto va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+		auto vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+		if (!_mm256_testz_si256(_mm256_cmpgt_epi32(va, vb), _mm256_set1_epi32(-1)))
+			return false;
+	}
+	if (i + 4 <= n) {
+		auto va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+		auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+		if (!_mm_testz_si128(_mm_cmpgt_epi32(va, vb), _mm_set1_epi32(-1)))
+			return false;
+		i += 4;
+	}
+	return leqScalar(a + i, b + i, n - i);
+}
+
+__attribute__((target("sse4.1"))) static void joinSSE41(int *dst, const int *src, unsigned int n)
+{
+	auto i = 0U;
+	for (; i + 4 <= n; i += 4) {
+		auto *d = reinterpret_cast<__m128i *>(dst + i);
+		auto s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+		_mm_storeu_si128(d, _mm_max_epi32(_mm_loadu_si128(d), s));
+	}
+	joinScalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("sse4.1"))) static auto leqSSE41(const int *a, const int *b,
+							unsigned int n) -> bool
+{
+	auto i = 0U;
+	for (; i + 4 <= n; i += 4) {
+		auto va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+		auto vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+		if (!_mm_testz_si128(_mm_cmpgt_epi32(va, vb), _mm_set1_epi32(-1)))
+			return false;
+	}
+	return leqScalar(a + i, b + i, n - i);
+}
+
+using JoinFun = void (*)(int *, const int *, unsigned int);
+using LeqFun = auto (*)(const int *, const int *, unsigned int) -> bool;
+
+/* Picks the best variant the CPU supports. Called on the first use of
+ * each kernel (rather than during static initialization), so that the
+ * kernels can be used by the initializers of other translation units */
+template <typename F> static auto select(F avx2, F sse41, F scalar) -> F
+{
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return avx2;
+	if (__builtin_cpu_supports("sse4.1"))
+		return sse41;
+	return scalar;
+}
+
+void joinVector(int *dst, const int *src, unsigned int n)
+{
+	static const auto impl = select<JoinFun>(joinAVX2, joinSSE41, joinScalar);
+	impl(dst, src, n);
+}
+
+auto leqVector(const int *a, const int *b, unsigned int n) -> bool
+{
+	static const auto impl = select<LeqFun>(leqAVX2, leqSSE41, leqScalar);
+	return impl(a, b, n);
+}
+
+#else /* !GENMC_VIEW_KERNELS_X86 */
+
+void joinVector(int *dst, const int *src, unsigned int n) { joinScalar(dst, src, n); }
+
+auto leqVector(const int *a, const int *b, unsigned int n) -> bool { return leqScalar(a, b, n); }
+
+#endif /* GENMC_VIEW_KERNELS_X86 */
+
+} // namespace ViewKernels
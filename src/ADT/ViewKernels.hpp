@@ -0,0 +1,69 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#ifndef GENMC_VIEW_KERNELS_HPP
+#define GENMC_VIEW_KERNELS_HPP
+
+#include <algorithm>
+
+/*
+ * Element-wise kernels over the entries of views (i.e., arrays of ints).
+ * Short views (fewer entries than a vector register holds) are handled
+ * inline. Longer ones go to vectorized (AVX2/SSE4.1) variants on x86,
+ * which are selected at the first call, depending on what the CPU
+ * supports; elsewhere, scalar loops are used.
+ */
+
+namespace ViewKernels {
+
+/** Views with fewer entries than this (i.e., than an SSE register holds)
+ * are not worth vectorizing */
+inline constexpr unsigned int minVectorSize = 4;
+
+/** The scalar variants */
+inline void joinScalar(int *dst, const int *src, unsigned int n)
+{
+	for (auto i = 0U; i < n; i++)
+		dst[i] = std::max(dst[i], src[i]);
+}
+
+inline auto leqScalar(const int *a, const int *b, unsigned int n) -> bool
+{
+	for (auto i = 0U; i < n; i++)
+		if (a[i] > b[i])
+			return false;
+	return true;
+}
+
+/** The variants the CPU supports best (used for long views) */
+void joinVector(int *dst, const int *src, unsigned int n);
+auto leqVector(const int *a, const int *b, unsigned int n) -> bool;
+
+/** Sets DST[i] to max(DST[i], SRC[i]) for all i < N */
+inline void join(int *dst, const int *src, unsigned int n)
+{
+	if (n < minVectorSize)
+		joinScalar(dst, src, n);
+	else
+		joinVector(dst, src, n);
+}
+
+/** Returns true if A[i] <= B[i] for all i < N */
+inline auto leq(const int *a, const int *b, unsigned int n) -> bool
+{
+	return n < minVectorSize ? leqScalar(a, b, n) : leqVector(a, b, n);
+}
+
+} // namespace ViewKernels
+
+#endif /* GENMC_VIEW_KERNELS_HPP */
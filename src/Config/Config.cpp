@@ -20,6 +20,7 @@
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <cstdlib>
 #include <filesystem>
 
 /*** Command-line argument categories ***/
@@ -55,6 +56,65 @@ static llvm::cl::opt<unsigned int>
 	clThreads("nthreads", llvm::cl::cat(clGeneral), llvm::cl::init(1),
 		  llvm::cl::desc("Number of threads to be used in the exploration"));
 
+static llvm::cl::opt<ParallelPolicy> clParallelPolicy(
+	"parallel-policy", llvm::cl::cat(clGeneral), llvm::cl::init(ParallelPolicy::Adaptive),
+	llvm::cl::desc("Choose when to submit work to other threads:"),
+	llvm::cl::values(clEnumValN(ParallelPolicy::Static, "static",
+				    "Whenever fewer than 8 tasks per thread are pending"),
+			 clEnumValN(ParallelPolicy::Adaptive, "adaptive",
+				    "Based on task duration, idle threads, and graph size "
+				    "(default)"),
+			 clEnumValN(ParallelPolicy::Deterministic, "deterministic",
+				    "At fixed points of each task, so that results (and "
+				    "reported errors) are reproducible")));
+
+static llvm::cl::opt<unsigned int> clDeterministicSplitDepth(
+	"deterministic-split-depth", llvm::cl::cat(clGeneral), llvm::cl::init(0),
+	llvm::cl::value_desc("N"),
+	llvm::cl::desc("Under the deterministic policy, split tasks up to depth N (default: "
+		       "derived from --nthreads). Results are reproducible for a given N"));
+
+static llvm::cl::opt<bool> clPrintParallelStats(
+	"print-parallel-stats", llvm::cl::cat(clGeneral),
+	llvm::cl::desc("Report how many tasks were shared among threads (or workers), and how "
+		       "long each of them was busy and idle"));
+
+static llvm::cl::opt<bool> clPrintNumaStats(
+	"print-numa-stats", llvm::cl::cat(clGeneral),
+	llvm::cl::desc("Report how many tasks idle threads took over from other NUMA nodes"));
+
+static llvm::cl::opt<unsigned int> clMemoryLimit(
+	"memory-limit", llvm::cl::cat(clGeneral), llvm::cl::init(0), llvm::cl::value_desc("MB"),
+	llvm::cl::desc("Try to keep the memory used for exploration below MB megabytes "
+		       "(split among threads) by dropping caches and handing work off "
+		       "to distributed workers"));
+
+static llvm::cl::opt<bool> clPrintMemoryStats(
+	"print-memory-stats", llvm::cl::cat(clGeneral),
+	llvm::cl::desc("Report the (estimated) peak memory used by each exploration component"));
+
+static llvm::cl::opt<unsigned int> clSpillExecStack(
+	"spill-exec-stack", llvm::cl::cat(clGeneral), llvm::cl::init(0), llvm::cl::value_desc("N"),
+	llvm::cl::desc("Only keep the top N entries of the execution stack in memory, and spill "
+		       "the rest to a temporary file"));
+
+static llvm::cl::opt<unsigned int> clDistributedWorkers(
+	"distributed-workers", llvm::cl::cat(clGeneral), llvm::cl::init(0),
+	llvm::cl::value_desc("N"),
+	llvm::cl::desc("Number of worker processes to distribute the exploration to "
+		       "(spawned locally, unless --distributed-listen is used)"));
+
+static llvm::cl::opt<std::string> clDistributedListen(
+	"distributed-listen", llvm::cl::cat(clGeneral), llvm::cl::value_desc("ADDR"),
+	llvm::cl::desc("Wait for --distributed-workers remote workers to connect to ADDR "
+		       "(unix:PATH or HOST:PORT; an empty HOST stands for the loopback interface). "
+		       "Workers have to present the secret set in $GENMC_DISTRIBUTED_TOKEN"));
+
+static llvm::cl::opt<std::string> clDistributedConnect(
+	"distributed-connect", llvm::cl::cat(clGeneral), llvm::cl::value_desc("ADDR"),
+	llvm::cl::desc("Act as a worker for the coordinator listening on ADDR. "
+		       "Input, options, and $GENMC_DISTRIBUTED_TOKEN must match the coordinator's"));
+
 static llvm::cl::opt<int>
 	clBound("bound", llvm::cl::cat(clGeneral), llvm::cl::init(-1), llvm::cl::value_desc("N"),
 		llvm::cl::desc("Do not explore executions exceeding given bound"));
@@ -273,6 +333,10 @@ static llvm::cl::opt<bool>
 	clValidateExecGraphs("validate-exec-graphs", llvm::cl::cat(clDebugging),
 			     llvm::cl::desc("Validate the execution graphs in each step"));
 
+static llvm::cl::opt<bool> clCheckGraphSerialization(
+	"check-graph-serialization", llvm::cl::cat(clDebugging),
+	llvm::cl::desc("Save and reload each complete execution graph, checking that it is preserved"));
+
 static llvm::cl::opt<bool>
 	clCountDuplicateExecs("count-duplicate-execs", llvm::cl::cat(clDebugging),
 			      llvm::cl::desc("Count duplicate executions (adds runtime overhead)"));
@@ -286,6 +350,17 @@ static llvm::cl::opt<bool> clPrintEstimationStats("print-estimation-stats",
 
 static llvm::cl::opt<bool> clRelincheDebug("relinche-debug", llvm::cl::cat(clDebugging),
 					   llvm::cl::desc("Enable debug printing for Relinche"));
+
+static llvm::cl::opt<unsigned int> clDistributedExitAfter(
+	"distributed-exit-after", llvm::cl::init(0), llvm::cl::value_desc("N"),
+	llvm::cl::cat(clDebugging),
+	llvm::cl::desc("Make the (first) distributed worker exit after exploring N tasks"));
+
+static llvm::cl::opt<unsigned int> clDistributedCrashAfter(
+	"distributed-crash-after", llvm::cl::init(0), llvm::cl::value_desc("N"),
+	llvm::cl::cat(clDebugging),
+	llvm::cl::desc("Make the (first) distributed worker crash right after submitting "
+		       "N executions"));
 #endif /* ENABLE_GENMC_DEBUG */
 
 static void printVersion(llvm::raw_ostream &s)
@@ -311,6 +386,14 @@ static auto doesPolicySupportSeed(const SchedulePolicy policy) -> bool
 	BUG(); /* Unknown SchedulePolicy */
 }
 
+/* The secret distributed workers authenticate with. It is passed through
+ * the environment so that it does not show up in the process list */
+static auto getDistributedToken() -> std::string
+{
+	const auto *token = std::getenv("GENMC_DISTRIBUTED_TOKEN");
+	return token ? token : "";
+}
+
 static void checkConfigOptions()
 {
 	/* Check exploration options */
@@ -354,6 +437,41 @@ static void checkConfigOptions()
 		clSchedulePolicy = SchedulePolicy::LTR;
 	}
 
+	/* Check parallelization options */
+	if (clThreads <= 1 && clParallelPolicy.getNumOccurrences() > 0) {
+		WARN("--parallel-policy used without --nthreads.\n");
+	}
+	if (clParallelPolicy != ParallelPolicy::Deterministic &&
+	    clDeterministicSplitDepth.getNumOccurrences() > 0) {
+		WARN("--deterministic-split-depth used without -parallel-policy=deterministic.\n");
+	}
+	if (clThreads <= 1 && clDistributedWorkers == 0 && clPrintParallelStats) {
+		WARN("--print-parallel-stats used without --nthreads or --distributed-workers.\n");
+	}
+	if (clThreads <= 1 && clPrintNumaStats) {
+		WARN("--print-numa-stats used without --nthreads.\n");
+	}
+	auto distributed = clDistributedWorkers > 0 || !clDistributedConnect.empty();
+	if (!clDistributedListen.empty() && clDistributedWorkers == 0)
+		ERROR("--distributed-listen requires --distributed-workers.\n");
+	if (!clDistributedConnect.empty() &&
+	    (clDistributedWorkers > 0 || !clDistributedListen.empty()))
+		ERROR("--distributed-connect cannot be used along with other distribution "
+		      "options.\n");
+	if ((!clDistributedListen.empty() || !clDistributedConnect.empty()) &&
+	    getDistributedToken().empty())
+		ERROR("Connecting distributed workers requires a shared secret in "
+		      "$GENMC_DISTRIBUTED_TOKEN.\n");
+#ifdef ENABLE_GENMC_DEBUG
+	if (!distributed && (clDistributedExitAfter > 0 || clDistributedCrashAfter > 0))
+		ERROR("--distributed-exit-after and --distributed-crash-after require "
+		      "distributed exploration.\n");
+#endif
+	if (distributed && clThreads > 1)
+		ERROR("Distributed exploration cannot be combined with --nthreads.\n");
+	if (distributed && (!clCollectLinSpec.empty() || !clCheckLinSpec.empty()))
+		ERROR("Distributed exploration does not support linearizability checks.\n");
+
 	/* Check Relinche options */
 	if (!clCollectLinSpec.empty() && !clCheckLinSpec.empty()) {
 		ERROR("Cannot collect and analyze linearizability specification in a single "
@@ -407,6 +525,24 @@ static void saveConfigOptions(Config &conf)
 	conf.sdThreshold = clEstimationSdThreshold;
 	conf.isDepTrackingModel = (conf.model == ModelType::IMM);
 	conf.threads = clThreads;
+	conf.parallelPolicy = clParallelPolicy;
+	conf.deterministicSplitDepth = clDeterministicSplitDepth > 0
+					       ? std::optional(clDeterministicSplitDepth.getValue())
+					       : std::nullopt;
+	conf.printParallelStats = clPrintParallelStats;
+	conf.printNumaStats = clPrintNumaStats;
+	conf.memoryLimit = clMemoryLimit > 0 ? std::optional(clMemoryLimit.getValue()) : std::nullopt;
+	conf.printMemoryStats = clPrintMemoryStats;
+	conf.spillExecStack =
+		clSpillExecStack > 0 ? std::optional(clSpillExecStack.getValue()) : std::nullopt;
+	conf.distributedWorkers = clDistributedWorkers;
+	conf.distributedListen = clDistributedListen.empty()
+					 ? std::nullopt
+					 : std::optional(clDistributedListen.getValue());
+	conf.distributedConnect = clDistributedConnect.empty()
+					  ? std::nullopt
+					  : std::optional(clDistributedConnect.getValue());
+	conf.distributedToken = getDistributedToken();
 	conf.bound = clBound >= 0 ? std::optional(clBound.getValue()) : std::nullopt;
 	conf.boundType = clBoundType;
 	conf.LAPOR = clLAPOR;
@@ -458,11 +594,14 @@ static void saveConfigOptions(Config &conf)
 	conf.printStamps = clPrintStamps;
 	conf.colorAccesses = clColorAccesses;
 	conf.validateExecGraphs = clValidateExecGraphs;
+	conf.checkGraphSerialization = clCheckGraphSerialization;
 	conf.countDuplicateExecs = clCountDuplicateExecs;
 	conf.countMootExecs = clCountMootExecs;
 	conf.printEstimationStats = clPrintEstimationStats;
 	conf.boundsHistogram = clBoundsHistogram;
 	conf.relincheDebug = clRelincheDebug;
+	conf.distributedExitAfter = clDistributedExitAfter;
+	conf.distributedCrashAfter = clDistributedCrashAfter;
 #endif
 }
 
@@ -24,6 +24,7 @@
 #include <string>
 
 enum class SchedulePolicy : std::uint8_t { LTR, WF, WFR, Arbitrary };
+enum class ParallelPolicy : std::uint8_t { Static, Adaptive, Deterministic };
 enum class BoundType : std::uint8_t { context, round };
 enum class InputType : std::uint8_t { clang, cargo, rust, llvmir };
 
@@ -38,6 +39,17 @@ struct Config {
 	bool estimate{};
 	bool isDepTrackingModel{};
 	unsigned int threads{};
+	ParallelPolicy parallelPolicy{};
+	std::optional<unsigned int> deterministicSplitDepth;
+	bool printParallelStats{};
+	bool printNumaStats{};
+	std::optional<unsigned int> memoryLimit;
+	bool printMemoryStats{};
+	std::optional<unsigned int> spillExecStack;
+	unsigned int distributedWorkers{};
+	std::optional<std::string> distributedListen;
+	std::optional<std::string> distributedConnect;
+	std::string distributedToken;
 	std::optional<unsigned int> bound;
 	BoundType boundType{};
 	bool LAPOR{};
@@ -92,11 +104,14 @@ struct Config {
 	bool printStamps{};
 	bool colorAccesses{};
 	bool validateExecGraphs{};
+	bool checkGraphSerialization{};
 	bool countDuplicateExecs{};
 	bool countMootExecs{};
 	bool printEstimationStats{};
 	bool boundsHistogram{};
 	bool relincheDebug{};
+	unsigned int distributedExitAfter{};
+	unsigned int distributedCrashAfter{};
 #endif
 };
 
@@ -6421,7 +6421,7 @@ bool IMMChecker::visitLHSUnlessWarning3_1(const EventLabel *lab, const View &v)
 	auto &g = *lab->getParent();
 
 	if (true && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessWarning3_0(pLab, v)) {
@@ -2109,7 +2109,7 @@ bool RAChecker::visitLHSUnlessError2_1(const EventLabel *lab) const
 	auto &g = *lab->getParent();
 
 	if (true && llvm::isa<FreeLabel>(lab) && !llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<FreeLabel>(pLab) &&
 				    !llvm::isa<HpRetireLabel>(pLab)) {
@@ -2118,7 +2118,7 @@ bool RAChecker::visitLHSUnlessError2_1(const EventLabel *lab) const
 					}
 				}
 	if (true && llvm::isa<FreeLabel>(lab) && !llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<HpRetireLabel>(pLab)) {
 					if (!visitLHSUnlessError2_0(pLab)) {
@@ -2126,7 +2126,7 @@ bool RAChecker::visitLHSUnlessError2_1(const EventLabel *lab) const
 					}
 				}
 	if (true && llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<FreeLabel>(pLab) &&
 				    !llvm::isa<HpRetireLabel>(pLab)) {
@@ -2135,7 +2135,7 @@ bool RAChecker::visitLHSUnlessError2_1(const EventLabel *lab) const
 					}
 				}
 	if (true && llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<HpRetireLabel>(pLab)) {
 					if (!visitLHSUnlessError2_0(pLab)) {
@@ -2476,7 +2476,7 @@ bool RAChecker::visitLHSUnlessError7_1(const EventLabel *lab, const View &v) con
 	auto &g = *lab->getParent();
 
 	if (true && lab->isNotAtomic() && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError7_0(pLab, v)) {
@@ -2484,7 +2484,7 @@ bool RAChecker::visitLHSUnlessError7_1(const EventLabel *lab, const View &v) con
 					}
 				}
 	if (true && lab->isNotAtomic() && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_reads(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<ReadLabel>(pLab)) {
 					if (!visitLHSUnlessError7_0(pLab, v)) {
@@ -2492,7 +2492,7 @@ bool RAChecker::visitLHSUnlessError7_1(const EventLabel *lab, const View &v) con
 					}
 				}
 	if (true && lab->isNotAtomic() && llvm::isa<ReadLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError7_0(pLab, v)) {
@@ -2500,7 +2500,7 @@ bool RAChecker::visitLHSUnlessError7_1(const EventLabel *lab, const View &v) con
 					}
 				}
 	if (true && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && pLab->isNotAtomic() && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError7_0(pLab, v)) {
@@ -2508,7 +2508,7 @@ bool RAChecker::visitLHSUnlessError7_1(const EventLabel *lab, const View &v) con
 					}
 				}
 	if (true && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_reads(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && pLab->isNotAtomic() && llvm::isa<ReadLabel>(pLab)) {
 					if (!visitLHSUnlessError7_0(pLab, v)) {
@@ -2516,7 +2516,7 @@ bool RAChecker::visitLHSUnlessError7_1(const EventLabel *lab, const View &v) con
 					}
 				}
 	if (true && llvm::isa<ReadLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && pLab->isNotAtomic() && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError7_0(pLab, v)) {
@@ -2566,7 +2566,7 @@ bool RAChecker::visitLHSUnlessWarning8_1(const EventLabel *lab, const View &v) c
 	auto &g = *lab->getParent();
 
 	if (true && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessWarning8_0(pLab, v)) {
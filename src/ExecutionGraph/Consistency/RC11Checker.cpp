@@ -4476,7 +4476,7 @@ bool RC11Checker::visitLHSUnlessError3_1(const EventLabel *lab) const
 	auto &g = *lab->getParent();
 
 	if (true && llvm::isa<FreeLabel>(lab) && !llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<FreeLabel>(pLab) &&
 				    !llvm::isa<HpRetireLabel>(pLab)) {
@@ -4485,7 +4485,7 @@ bool RC11Checker::visitLHSUnlessError3_1(const EventLabel *lab) const
 					}
 				}
 	if (true && llvm::isa<FreeLabel>(lab) && !llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<HpRetireLabel>(pLab)) {
 					if (!visitLHSUnlessError3_0(pLab)) {
@@ -4493,7 +4493,7 @@ bool RC11Checker::visitLHSUnlessError3_1(const EventLabel *lab) const
 					}
 				}
 	if (true && llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<FreeLabel>(pLab) &&
 				    !llvm::isa<HpRetireLabel>(pLab)) {
@@ -4502,7 +4502,7 @@ bool RC11Checker::visitLHSUnlessError3_1(const EventLabel *lab) const
 					}
 				}
 	if (true && llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<HpRetireLabel>(pLab)) {
 					if (!visitLHSUnlessError3_0(pLab)) {
@@ -4843,7 +4843,7 @@ bool RC11Checker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) c
 	auto &g = *lab->getParent();
 
 	if (true && lab->isNotAtomic() && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -4851,7 +4851,7 @@ bool RC11Checker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) c
 					}
 				}
 	if (true && lab->isNotAtomic() && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_reads(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<ReadLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -4859,7 +4859,7 @@ bool RC11Checker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) c
 					}
 				}
 	if (true && lab->isNotAtomic() && llvm::isa<ReadLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -4867,7 +4867,7 @@ bool RC11Checker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) c
 					}
 				}
 	if (true && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && pLab->isNotAtomic() && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -4875,7 +4875,7 @@ bool RC11Checker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) c
 					}
 				}
 	if (true && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_reads(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && pLab->isNotAtomic() && llvm::isa<ReadLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -4883,7 +4883,7 @@ bool RC11Checker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) c
 					}
 				}
 	if (true && llvm::isa<ReadLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && pLab->isNotAtomic() && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -4933,7 +4933,7 @@ bool RC11Checker::visitLHSUnlessWarning9_1(const EventLabel *lab, const View &v)
 	auto &g = *lab->getParent();
 
 	if (true && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessWarning9_0(pLab, v)) {
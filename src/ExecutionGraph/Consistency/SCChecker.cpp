@@ -1216,7 +1216,7 @@ bool SCChecker::visitLHSUnlessError3_1(const EventLabel *lab) const
 	auto &g = *lab->getParent();
 
 	if (true && llvm::isa<FreeLabel>(lab) && !llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<FreeLabel>(pLab) &&
 				    !llvm::isa<HpRetireLabel>(pLab)) {
@@ -1225,7 +1225,7 @@ bool SCChecker::visitLHSUnlessError3_1(const EventLabel *lab) const
 					}
 				}
 	if (true && llvm::isa<FreeLabel>(lab) && !llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<HpRetireLabel>(pLab)) {
 					if (!visitLHSUnlessError3_0(pLab)) {
@@ -1233,7 +1233,7 @@ bool SCChecker::visitLHSUnlessError3_1(const EventLabel *lab) const
 					}
 				}
 	if (true && llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<FreeLabel>(pLab) &&
 				    !llvm::isa<HpRetireLabel>(pLab)) {
@@ -1242,7 +1242,7 @@ bool SCChecker::visitLHSUnlessError3_1(const EventLabel *lab) const
 					}
 				}
 	if (true && llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<HpRetireLabel>(pLab)) {
 					if (!visitLHSUnlessError3_0(pLab)) {
@@ -1583,7 +1583,7 @@ bool SCChecker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) con
 	auto &g = *lab->getParent();
 
 	if (true && lab->isNotAtomic() && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -1591,7 +1591,7 @@ bool SCChecker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) con
 					}
 				}
 	if (true && lab->isNotAtomic() && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_reads(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<ReadLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -1599,7 +1599,7 @@ bool SCChecker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) con
 					}
 				}
 	if (true && lab->isNotAtomic() && llvm::isa<ReadLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -1607,7 +1607,7 @@ bool SCChecker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) con
 					}
 				}
 	if (true && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && pLab->isNotAtomic() && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -1615,7 +1615,7 @@ bool SCChecker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) con
 					}
 				}
 	if (true && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_reads(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && pLab->isNotAtomic() && llvm::isa<ReadLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -1623,7 +1623,7 @@ bool SCChecker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) con
 					}
 				}
 	if (true && llvm::isa<ReadLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && pLab->isNotAtomic() && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -1673,7 +1673,7 @@ bool SCChecker::visitLHSUnlessWarning9_1(const EventLabel *lab, const View &v) c
 	auto &g = *lab->getParent();
 
 	if (true && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessWarning9_0(pLab, v)) {
@@ -1643,7 +1643,7 @@ bool TSOChecker::visitLHSUnlessError3_1(const EventLabel *lab) const
 	auto &g = *lab->getParent();
 
 	if (true && llvm::isa<FreeLabel>(lab) && !llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<FreeLabel>(pLab) &&
 				    !llvm::isa<HpRetireLabel>(pLab)) {
@@ -1652,7 +1652,7 @@ bool TSOChecker::visitLHSUnlessError3_1(const EventLabel *lab) const
 					}
 				}
 	if (true && llvm::isa<FreeLabel>(lab) && !llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<HpRetireLabel>(pLab)) {
 					if (!visitLHSUnlessError3_0(pLab)) {
@@ -1660,7 +1660,7 @@ bool TSOChecker::visitLHSUnlessError3_1(const EventLabel *lab) const
 					}
 				}
 	if (true && llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<FreeLabel>(pLab) &&
 				    !llvm::isa<HpRetireLabel>(pLab)) {
@@ -1669,7 +1669,7 @@ bool TSOChecker::visitLHSUnlessError3_1(const EventLabel *lab) const
 					}
 				}
 	if (true && llvm::isa<HpRetireLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_frees(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<HpRetireLabel>(pLab)) {
 					if (!visitLHSUnlessError3_0(pLab)) {
@@ -2010,7 +2010,7 @@ bool TSOChecker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) co
 	auto &g = *lab->getParent();
 
 	if (true && lab->isNotAtomic() && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -2018,7 +2018,7 @@ bool TSOChecker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) co
 					}
 				}
 	if (true && lab->isNotAtomic() && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_reads(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<ReadLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -2026,7 +2026,7 @@ bool TSOChecker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) co
 					}
 				}
 	if (true && lab->isNotAtomic() && llvm::isa<ReadLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -2034,7 +2034,7 @@ bool TSOChecker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) co
 					}
 				}
 	if (true && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && pLab->isNotAtomic() && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -2042,7 +2042,7 @@ bool TSOChecker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) co
 					}
 				}
 	if (true && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_reads(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && pLab->isNotAtomic() && llvm::isa<ReadLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -2050,7 +2050,7 @@ bool TSOChecker::visitLHSUnlessError8_1(const EventLabel *lab, const View &v) co
 					}
 				}
 	if (true && llvm::isa<ReadLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && pLab->isNotAtomic() && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessError8_0(pLab, v)) {
@@ -2100,7 +2100,7 @@ bool TSOChecker::visitLHSUnlessWarning9_1(const EventLabel *lab, const View &v)
 	auto &g = *lab->getParent();
 
 	if (true && llvm::isa<WriteLabel>(lab))
-		for (auto &tmp : samelocs(g, lab))
+		for (auto &tmp : samelocs_writes(g, lab))
 			if (auto *pLab = &tmp; true)
 				if (true && llvm::isa<WriteLabel>(pLab)) {
 					if (!visitLHSUnlessWarning9_0(pLab, v)) {
@@ -126,6 +126,25 @@ void DepExecutionGraph::cutToStamp(Stamp stamp)
 	resetStamp(0U);
 	for (auto &lab : labels())
 		lab.setStamp(nextStamp());
+	for (auto &loc : locations_)
+		loc.accesses.sortByStamp();
+
+	/* Drop the views of the removed labels, by moving the views of
+	 * the remaining ones (in store order) to the front of the store */
+	std::vector<EventLabel *> withViews;
+	for (auto &lab : labels())
+		if (lab.viewsOffset)
+			withViews.push_back(&lab);
+	std::ranges::sort(withViews, {}, [](auto *lab) { return *lab->viewsOffset; });
+	auto viewsEnd = 0U;
+	for (auto *lab : withViews) {
+		std::move(viewStore_.begin() + *lab->viewsOffset,
+			  viewStore_.begin() + *lab->viewsOffset + lab->numViews,
+			  viewStore_.begin() + viewsEnd);
+		lab->viewsOffset = viewsEnd;
+		viewsEnd += lab->numViews;
+	}
+	viewStore_.erase(viewStore_.begin() + viewsEnd, viewStore_.end());
 
 	/* Finally, do not keep any nullptrs in the graph */
 	for (auto i = 0u; i < getNumThreads(); i++) {
@@ -12,6 +12,20 @@
  */
 
 #include "Event.hpp"
+#include "Support/Serialization.hpp"
+
+void Event::serialize(ByteWriter &out) const
+{
+	out.writeS64(thread);
+	out.writeS64(index);
+}
+
+auto Event::deserialize(ByteReader &in) -> Event
+{
+	auto thread = in.readS64();
+	auto index = in.readS64();
+	return {static_cast<int>(thread), static_cast<int>(index)};
+}
 
 auto operator<<(llvm::raw_ostream &s, Event e) -> llvm::raw_ostream &
 {
@@ -19,6 +19,9 @@
 #include <llvm/ADT/Hashing.h>
 #include <llvm/Support/raw_ostream.h>
 
+class ByteWriter;
+class ByteReader;
+
 /**
  * Represents the position of a given label in an execution graph.
  */
@@ -71,6 +74,10 @@ struct Event {
 		return tmp;
 	}
 
+	/** Serialization facilities (see Support/Serialization.hpp) */
+	void serialize(ByteWriter &out) const;
+	static auto deserialize(ByteReader &in) -> Event;
+
 	static auto hash_value(const Event &e) -> llvm::hash_code
 	{
 		return llvm::hash_combine(e.thread, e.index);
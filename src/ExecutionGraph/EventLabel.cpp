@@ -32,6 +32,17 @@ SVal EventLabel::getAccessValue(const AAccess &access) const
 	return wLab->getVal();
 }
 
+void EventLabel::addView(View &&view) { getParent()->addView(this, std::move(view)); }
+
+const View &EventLabel::view(size_t i) const
+{
+	/* The initializer and holes only have an empty view */
+	static const View empty;
+	if (getPos().isInitializer() || getKind() == Empty)
+		return empty;
+	return getParent()->getView(this, i);
+}
+
 SVal EventLabel::getReturnValue() const
 {
 	if (auto *rLab = llvm::dyn_cast<ReadLabel>(this)) {
@@ -52,12 +63,35 @@ SVal EventLabel::getReturnValue() const
 	BUG();
 }
 
+auto InitLabel::rf_begin(SAddr addr) -> rf_iterator { return getParent()->init_rf_begin(addr); }
+
+auto InitLabel::rf_begin(SAddr addr) const -> const_rf_iterator
+{
+	return getParent()->init_rf_begin(addr);
+}
+
+auto InitLabel::rf_end(SAddr addr) -> rf_iterator { return getParent()->init_rf_end(addr); }
+
+auto InitLabel::rf_end(SAddr addr) const -> const_rf_iterator
+{
+	return getParent()->init_rf_end(addr);
+}
+
 void InitLabel::addReader(ReadLabel *rLab)
 {
 	BUG_ON(std::find_if(rf_begin(rLab->getAddr()), rf_end(rLab->getAddr()),
 			    [rLab](ReadLabel &oLab) { return oLab.getPos() == rLab->getPos(); }) !=
 	       rf_end(rLab->getAddr()));
-	initRfs[rLab->getAddr()].push_back(*rLab);
+	getParent()->getLoc(rLab).initRfs.push_back(*rLab);
+}
+
+void InitLabel::removeReader(ReadLabel *rLab)
+{
+	auto &readers = getParent()->getLoc(rLab).initRfs;
+	auto it = std::find_if(readers.begin(), readers.end(),
+			       [rLab](ReadLabel &oLab) { return &oLab == rLab; });
+	if (it != readers.end())
+		readers.erase(it);
 }
 
 void MethodBeginLabel::addPred(MethodEndLabel *predLab)
@@ -171,8 +205,7 @@ void ReadLabel::setRf(EventLabel *rfLab)
 		if (auto *oldLab = llvm::dyn_cast<WriteLabel>(oldRfLab))
 			oldLab->removeReader([&](ReadLabel &oLab) { return &oLab == this; });
 		else if (auto *oldLab = llvm::dyn_cast<InitLabel>(oldRfLab))
-			oldLab->removeReader(getAddr(),
-					     [&](ReadLabel &oLab) { return &oLab == this; });
+			oldLab->removeReader(this);
 		else
 			BUG();
 	}
@@ -192,16 +225,12 @@ void ReadLabel::setRf(EventLabel *rfLab)
 
 void WriteLabel::addCo(EventLabel *predLab)
 {
-	auto &g = *getParent();
-	auto *predLabW = llvm::dyn_cast<WriteLabel>(predLab);
-	g.coherence[getAddr()].insert(
-		predLabW ? ++ExecutionGraph::co_iterator(*predLabW) : g.co_begin(getAddr()), *this);
+	getParent()->addToCo(this, llvm::dyn_cast<WriteLabel>(predLab));
 }
 
 void WriteLabel::moveCo(EventLabel *predLab)
 {
-	auto &g = *getParent();
-	g.coherence[getAddr()].remove(*this);
+	getParent()->removeFromCo(this);
 	addCo(predLab);
 }
 
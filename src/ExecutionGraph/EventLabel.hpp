@@ -29,6 +29,7 @@
 #include "Support/RMWOps.hpp"
 #include "Support/SAddr.hpp"
 #include "Support/SVal.hpp"
+#include "Support/SlabAllocator.hpp"
 #include "Support/ThreadInfo.hpp"
 
 #include <llvm/ADT/ilist_node.h>
@@ -102,6 +103,21 @@ protected:
 public:
 	virtual ~EventLabel() = default;
 
+	/** Labels are created (and copied) in large numbers while exploring,
+	 * so they are allocated from slabs. As the destructor is virtual,
+	 * the size passed to delete is the one of the dynamic type */
+	static auto operator new(std::size_t size) -> void * { return SlabAllocator::allocate(size); }
+	static void operator delete(void *p, std::size_t size) { SlabAllocator::deallocate(p, size); }
+
+	/** Labels can also be allocated from the region of a graph (see clone()).
+	 * Deleting them (through the operator above) then hands their memory back
+	 * to the region; the one below is only used if a constructor throws */
+	static auto operator new(std::size_t size, SlabAllocator::Region &region) -> void *
+	{
+		return region.allocate(size);
+	}
+	static void operator delete(void *, SlabAllocator::Region &) {}
+
 	/** Iterators for dependencies */
 	const_dep_iterator data_begin() const { return deps.data.begin(); }
 	const_dep_iterator data_end() const { return deps.data.end(); }
@@ -169,8 +185,10 @@ public:
 
 	void setCalculated(std::vector<VSet<Event>> &&calc) { calculatedRels = std::move(calc); }
 
-	void setViews(std::vector<View> &&views) { calculatedViews = std::move(views); }
-	void addView(View &&view) { calculatedViews.emplace_back(view); }
+	/** Appends VIEW to the calculated views of this label.
+	 * (The label needs to be part of a graph, and the views of all
+	 * labels added to the graph afterwards need to be calculated later) */
+	void addView(View &&view);
 
 	/** Iterators for calculated relations */
 	calc_const_range calculated(size_t i) const
@@ -179,12 +197,8 @@ public:
 									: calculatedRels[i];
 	}
 
-	/** Getters for calculated views */
-	const View &view(size_t i) const
-	{
-		return (getPos().isInitializer() || getKind() == Empty) ? calculatedViews[0]
-									: calculatedViews[i];
-	}
+	/** Getters for calculated views (stored in the graph; see ExecutionGraph::getView()) */
+	const View &view(size_t i) const;
 
 	/** Returns true if this label corresponds to a non-atomic access */
 	bool isNotAtomic() const { return ordering == MemOrdering::NotAtomic; }
@@ -239,13 +253,20 @@ public:
 	/** Returns a clone object (virtual to allow deep copying from base) */
 	virtual std::unique_ptr<EventLabel> clone() const = 0;
 
+	/** Returns a clone object allocated from REGION */
+	virtual std::unique_ptr<EventLabel> clone(SlabAllocator::Region &region) const = 0;
+
+	/** Returns the size of the label object in bytes (used for memory accounting) */
+	virtual size_t getFootprint() const = 0;
+
 	/** Resets all graph-related info on a label to their default values */
 	virtual void reset()
 	{
 		parent = nullptr;
 		stamp = std::nullopt;
 		calculatedRels.clear();
-		calculatedViews.clear();
+		viewsOffset = std::nullopt;
+		numViews = 0;
 		prefixView = nullptr;
 		revisitable = true;
 	}
@@ -285,8 +306,9 @@ private:
 	/** Saved calculations */
 	std::vector<VSet<Event>> calculatedRels;
 
-	/** Saved views */
-	std::vector<View> calculatedViews;
+	/** Where the saved views are in the parent's view store */
+	std::optional<unsigned> viewsOffset = std::nullopt;
+	unsigned numViews = 0;
 
 	/** Revisitability status */
 	bool revisitable = true;
@@ -301,7 +323,14 @@ private:
 	std::unique_ptr<EventLabel> clone() const override                                         \
 	{                                                                                          \
 		return std::make_unique<name##Label>(*this);                                       \
-	}
+	}                                                                                          \
+                                                                                                   \
+	std::unique_ptr<EventLabel> clone(SlabAllocator::Region &region) const override            \
+	{                                                                                          \
+		return std::unique_ptr<EventLabel>(new (region) name##Label(*this));               \
+	}                                                                                          \
+                                                                                                   \
+	size_t getFootprint() const override { return sizeof(name##Label); }
 
 #define DEFINE_STANDARD_MEMBERS(name)                                                              \
 	DEFINE_CREATE_CLONE(name)                                                                  \
@@ -404,12 +433,13 @@ public:
 	using rf_iterator = ReaderList::iterator;
 	using const_rf_iterator = ReaderList::const_iterator;
 
-	rf_iterator rf_begin(SAddr addr) { return initRfs[addr].begin(); }
-	const_rf_iterator rf_begin(SAddr addr) const { return initRfs.at(addr).begin(); };
-	rf_iterator rf_end(SAddr addr) { return initRfs[addr].end(); }
-	const_rf_iterator rf_end(SAddr addr) const { return initRfs.at(addr).end(); }
-	auto rfs(SAddr addr) const { return std::views::all(initRfs.at(addr)); }
-	auto rfs(SAddr addr) { return std::views::all(initRfs.at(addr)); }
+	/* The readers are kept in the per-location information of the graph */
+	rf_iterator rf_begin(SAddr addr);
+	const_rf_iterator rf_begin(SAddr addr) const;
+	rf_iterator rf_end(SAddr addr);
+	const_rf_iterator rf_end(SAddr addr) const;
+	auto rfs(SAddr addr) const { return std::ranges::subrange(rf_begin(addr), rf_end(addr)); }
+	auto rfs(SAddr addr) { return std::ranges::subrange(rf_begin(addr), rf_end(addr)); }
 
 	DEFINE_STANDARD_MEMBERS(Init)
 
@@ -418,18 +448,7 @@ private:
 
 	void addReader(ReadLabel *rLab);
 
-	/** Removes all readers that satisfy predicate F */
-	template <typename F> void removeReader(SAddr addr, F cond)
-	{
-		for (auto it = rf_begin(addr); it != rf_end(addr);) {
-			if (cond(*it))
-				it = initRfs[addr].erase(it);
-			else
-				++it;
-		}
-	}
-
-	std::unordered_map<SAddr, ReaderList> initRfs;
+	void removeReader(ReadLabel *rLab);
 };
 
 /*******************************************************************************
@@ -635,6 +654,8 @@ public:
 	DEFINE_CLASSOF_RANGE(MemAccess)
 
 private:
+	friend class ExecutionGraph;
+
 	/** The access performed */
 	AAccess access;
 
@@ -643,6 +664,9 @@ private:
 
 	/** The allocation event corresponding to this access */
 	MallocLabel *allocLab = nullptr;
+
+	/** The ID of the accessed location in the graph (set by the graph) */
+	unsigned locId = 0;
 };
 
 /*******************************************************************************
@@ -1166,6 +1190,10 @@ private:
 
 	/** Attributes of the write */
 	WriteAttr wattr = WriteAttr::None;
+
+	/** The index of the write in its location's packed
+	 * coherence order (maintained by the graph) */
+	unsigned coIdx = 0;
 };
 
 #define WRITE_PURE_SUBCLASS(_class_kind)                                                           \
@@ -14,6 +14,7 @@
 #include "ExecutionGraph.hpp"
 #include <llvm/IR/DebugInfo.h>
 
+#include <algorithm>
 #include <memory>
 
 /************************************************************
@@ -24,20 +25,18 @@
  * In the case where the events are not added out-of-order in the graph
  * (i.e., an event has a larger timestamp than all its po-predecessors)
  * we can obtain a view of the graph, given a timestamp. This function
- * returns such a view.
+ * returns such a view. (As stamps are increasing along each thread,
+ * it suffices to binary-search each thread.)
  */
 auto ExecutionGraph::getViewFromStamp(Stamp stamp) const -> std::unique_ptr<VectorClock>
 {
 	auto preds = std::make_unique<View>();
 
 	for (auto i = 0U; i < getNumThreads(); i++) {
-		for (auto j = (int)getThreadSize(i) - 1; j >= 0; j--) {
-			const auto *lab = getEventLabel(Event(i, j));
-			if (lab->getStamp() <= stamp) {
-				preds->setMax(Event(i, j));
-				break;
-			}
-		}
+		auto it = std::ranges::partition_point(
+			events[i], [&](auto &lab) { return lab->getStamp() <= stamp; });
+		if (it != events[i].begin())
+			preds->setMax(Event(i, std::distance(events[i].begin(), it) - 1));
 	}
 	return preds;
 }
@@ -54,16 +53,17 @@ auto ExecutionGraph::addLabelToGraph(std::unique_ptr<EventLabel> lab) -> EventLa
 	if (!lab->hasStamp())
 		lab->setStamp(nextStamp());
 
-	/* Track coherence if necessary */
+	/* Index the accesses to each location by kind (see AccessIndex):
+	 * reads and writes, which also track coherence, and frees (allocations
+	 * are not indexed) */
 	if (auto *mLab = llvm::dyn_cast<MemAccessLabel>(&*lab)) {
-		trackCoherenceAtLoc(mLab->getAddr());
-		accessMap_[mLab->getAddr()].push_back(&*lab);
-	}
-	/* XXX: Track accesses to each location (no allocs; temp fix) */
-	if (auto *dLab = llvm::dyn_cast<FreeLabel>(&*lab)) {
-		trackCoherenceAtLoc(dLab->getFreedAddr());
-		accessMap_[dLab->getFreedAddr()].push_back(&*lab);
+		mLab->locId = getLocId(mLab->getAddr());
+		auto &loc = getLoc(mLab);
+		loc.tracked = true;
+		loc.accesses.add(&*lab);
 	}
+	if (auto *dLab = llvm::dyn_cast<FreeLabel>(&*lab))
+		getLoc(dLab->getFreedAddr()).accesses.add(&*lab);
 
 	auto pos = lab->getPos();
 	auto *lastLab = getLastThreadLabel(pos.thread);
@@ -87,11 +87,36 @@ auto ExecutionGraph::addLabelToGraph(std::unique_ptr<EventLabel> lab) -> EventLa
 	return &newLab;
 }
 
-void ExecutionGraph::trackCoherenceAtLoc(SAddr addr)
+void ExecutionGraph::trackCoherenceAtLoc(SAddr addr) { getLoc(addr); }
+
+void ExecutionGraph::addToCo(WriteLabel *wLab, WriteLabel *predLab)
+{
+	auto &loc = getLoc(wLab);
+	loc.stores.insert(predLab ? ++co_iterator(*predLab) : loc.stores.begin(), *wLab);
+
+	auto idx = predLab ? predLab->coIdx + 1 : 0U;
+	loc.coArray.insert(loc.coArray.begin() + idx, wLab);
+	for (auto i = idx; i < loc.coArray.size(); i++)
+		loc.coArray[i]->coIdx = i;
+}
+
+void ExecutionGraph::removeFromCo(WriteLabel *wLab)
+{
+	auto &loc = getLoc(wLab);
+	loc.stores.remove(*wLab);
+
+	loc.coArray.erase(loc.coArray.begin() + wLab->coIdx);
+	for (auto i = wLab->coIdx; i < loc.coArray.size(); i++)
+		loc.coArray[i]->coIdx = i;
+}
+
+void ExecutionGraph::repackCo(Location &loc)
 {
-	coherence[addr];
-	getInitLabel()->initRfs.emplace(addr, CopyableIList<ReadLabel>());
-	accessMap_[addr];
+	loc.coArray.clear();
+	for (auto &sLab : loc.stores) {
+		sLab.coIdx = loc.coArray.size();
+		loc.coArray.push_back(&sLab);
+	}
 }
 
 void ExecutionGraph::addAlloc(MallocLabel *aLab, MemAccessLabel *mLab)
@@ -106,6 +131,38 @@ void ExecutionGraph::addAlloc(MallocLabel *aLab, MemAccessLabel *mLab)
  ** Graph modification methods
  ***********************************************************/
 
+void ExecutionGraph::addView(EventLabel *lab, View &&v)
+{
+	if (!lab->viewsOffset)
+		lab->viewsOffset = viewStore_.size();
+	BUG_ON(*lab->viewsOffset + lab->numViews != viewStore_.size());
+
+	++lab->numViews;
+	viewStore_.push_back(std::move(v));
+}
+
+void ExecutionGraph::appendViews(EventLabel *lab, const std::vector<View> &store, unsigned base)
+{
+	if (!lab->viewsOffset)
+		return;
+
+	auto offset = *lab->viewsOffset - base;
+	lab->viewsOffset = viewStore_.size();
+	viewStore_.insert(viewStore_.end(), store.begin() + offset,
+			  store.begin() + offset + lab->numViews);
+}
+
+void ExecutionGraph::moveViews(EventLabel *lab, std::vector<View> &store, unsigned base)
+{
+	if (!lab->viewsOffset)
+		return;
+
+	auto offset = *lab->viewsOffset - base;
+	lab->viewsOffset = viewStore_.size();
+	viewStore_.insert(viewStore_.end(), std::make_move_iterator(store.begin() + offset),
+			  std::make_move_iterator(store.begin() + offset + lab->numViews));
+}
+
 void ExecutionGraph::removeLast(unsigned int thread)
 {
 	auto *lab = getLastThreadLabel(thread);
@@ -122,13 +179,11 @@ void ExecutionGraph::removeLast(unsigned int thread)
 	if (auto *mLab = llvm::dyn_cast<MemAccessLabel>(lab)) {
 		if (auto *aLab = llvm::dyn_cast_or_null<MallocLabel>(mLab->getAlloc()))
 			aLab->removeAccess([&](auto &oLab) { return &oLab == mLab; });
-		auto &accesses = accessMap_[mLab->getAddr()];
-		accesses.erase(std::remove(accesses.begin(), accesses.end(), mLab), accesses.end());
+		getLoc(mLab).accesses.remove(mLab);
 	}
 	if (auto *dLab = llvm::dyn_cast<FreeLabel>(lab)) {
 		dLab->getAlloc()->setFree(nullptr);
-		auto &accesses = accessMap_[dLab->getFreedAddr()];
-		accesses.erase(std::remove(accesses.begin(), accesses.end(), dLab), accesses.end());
+		getLoc(dLab->getFreedAddr()).accesses.remove(dLab);
 	}
 	if (auto *aLab = llvm::dyn_cast<MallocLabel>(lab)) {
 		if (auto *dLab = llvm::dyn_cast_or_null<FreeLabel>(aLab->getFree()))
@@ -145,6 +200,8 @@ void ExecutionGraph::removeLast(unsigned int thread)
 			eLab->setParentJoin(nullptr);
 	}
 	/* Nothing to do for start/finish: childId remains the same */
+	if (lab->viewsOffset && *lab->viewsOffset + lab->numViews == viewStore_.size())
+		viewStore_.erase(viewStore_.begin() + *lab->viewsOffset, viewStore_.end());
 	insertionOrder.remove(*lab);
 	poLists[lab->getThread()].remove(*lab);
 	events[thread].pop_back();
@@ -163,29 +220,81 @@ void ExecutionGraph::removeAfter(const VectorClock &preds)
 		}
 	}
 
-	for (auto lIt = coherence.begin(); lIt != coherence.end(); /* empty */) {
+	for (auto &loc : locations_) {
+		if (!loc.tracked)
+			continue;
+
 		/* Should we keep this memory location lying around? */
-		if (!keep.count(lIt->first)) {
-			getInitLabel()->initRfs.erase(lIt->first);
-			accessMap_.erase(lIt->first);
-			lIt = coherence.erase(lIt);
-		} else {
-			for (auto sIt = lIt->second.begin(); sIt != lIt->second.end();) {
-				if (!preds.contains(sIt->getPos()))
-					sIt = lIt->second.erase(sIt);
-				else
-					++sIt;
-			}
-			getInitLabel()->removeReader(lIt->first, [&](auto &rLab) {
-				return !preds.contains(rLab.getPos());
-			});
-			auto &accesses = accessMap_[lIt->first];
-			accesses.erase(std::remove_if(accesses.begin(), accesses.end(),
-						      [&](auto *lab) {
-							      return !preds.contains(lab->getPos());
-						      }),
-				       accesses.end());
-			++lIt;
+		if (!keep.count(loc.addr)) {
+			untrackLoc(loc);
+			continue;
+		}
+		for (auto sIt = loc.stores.begin(); sIt != loc.stores.end();) {
+			if (!preds.contains(sIt->getPos()))
+				sIt = loc.stores.erase(sIt);
+			else
+				++sIt;
+		}
+		repackCo(loc);
+		for (auto rIt = loc.initRfs.begin(); rIt != loc.initRfs.end();) {
+			if (!preds.contains(rIt->getPos()))
+				rIt = loc.initRfs.erase(rIt);
+			else
+				++rIt;
+		}
+		loc.accesses.removeIf([&](auto *lab) { return !preds.contains(lab->getPos()); });
+	}
+}
+
+void ExecutionGraph::unlinkCutLabel(EventLabel *lab, const VectorClock &preds,
+				    VSet<SAddr> &cutLocs)
+{
+	/* Only the labels that remain in the graph need to be updated */
+	auto isKept = [&](auto *oLab) { return preds.contains(oLab->getPos()); };
+
+	if (auto *rLab = llvm::dyn_cast<ReadLabel>(lab)) {
+		auto *wLab = llvm::dyn_cast_or_null<WriteLabel>(rLab->getRf());
+		if (wLab && isKept(wLab))
+			wLab->removeReader([&](ReadLabel &oLab) { return &oLab == rLab; });
+		else if (!wLab)
+			removeInitRfToLoc(rLab);
+	}
+	if (auto *wLab = llvm::dyn_cast<WriteLabel>(lab)) {
+		getLoc(wLab).stores.remove(*wLab);
+		for (auto &rLab : wLab->readers()) {
+			if (isKept(&rLab))
+				rLab.setRfNoCascade(nullptr);
+		}
+	}
+	if (auto *mLab = llvm::dyn_cast<MemAccessLabel>(lab)) {
+		auto *aLab = llvm::dyn_cast_or_null<MallocLabel>(mLab->getAlloc());
+		if (aLab && isKept(aLab))
+			aLab->removeAccess([&](auto &oLab) { return &oLab == mLab; });
+		cutLocs.insert(mLab->getAddr());
+	}
+	if (auto *dLab = llvm::dyn_cast<FreeLabel>(lab)) {
+		if (dLab->getAlloc() && isKept(dLab->getAlloc()))
+			dLab->getAlloc()->setFree(nullptr);
+		cutLocs.insert(dLab->getFreedAddr());
+	}
+	if (auto *aLab = llvm::dyn_cast<MallocLabel>(lab)) {
+		if (aLab->getFree() && isKept(aLab->getFree()))
+			llvm::cast<FreeLabel>(aLab->getFree())->setAlloc(nullptr);
+		for (auto &mLab : aLab->accesses()) {
+			if (isKept(&mLab))
+				mLab.setAlloc(nullptr);
+		}
+	}
+	if (auto *begLab = llvm::dyn_cast<MethodBeginLabel>(lab)) {
+		for (auto *endLab : begLab->lin_preds()) {
+			if (isKept(endLab))
+				endLab->removeSuccNoCascade([&](auto *oLab) { return oLab == begLab; });
+		}
+	}
+	if (auto *endLab = llvm::dyn_cast<MethodEndLabel>(lab)) {
+		for (auto *begLab : endLab->lin_succs()) {
+			if (isKept(begLab))
+				begLab->removePredNoCascade([&](auto *oLab) { return oLab == endLab; });
 		}
 	}
 }
@@ -194,9 +303,47 @@ void ExecutionGraph::cutToStamp(Stamp stamp)
 {
 	auto preds = getViewFromStamp(stamp);
 
-	/* Inform all calculators about the events cutted */
-	removeAfter(*preds);
-	for (auto labIt = insertionOrder.begin(), labE = insertionOrder.end(); labIt != labE;) {
+	/* Stamps are increasing along the insertion order, so the labels to
+	 * be removed all lie in the suffix with stamps larger than STAMP
+	 * (along with some begins, which are kept around) */
+	auto cutIt = insertionOrder.end();
+	while (cutIt != insertionOrder.begin() && std::prev(cutIt)->getStamp() > stamp)
+		--cutIt;
+
+	/* Remove any 'pointers' to events that will be removed.
+	 * (The views of the suffix come after all others in the store) */
+	VSet<SAddr> cutLocs;
+	auto viewsCut = static_cast<unsigned>(viewStore_.size());
+	for (auto &lab : std::ranges::subrange(cutIt, insertionOrder.end())) {
+		if (lab.viewsOffset)
+			viewsCut = std::min(viewsCut, *lab.viewsOffset);
+		if (!preds->contains(lab.getPos()))
+			unlinkCutLabel(&lab, *preds, cutLocs);
+	}
+	for (auto i = 0U; i < getNumThreads(); i++) {
+		if (isThreadEmpty(i))
+			continue;
+		auto *tsLab = llvm::dyn_cast<ThreadStartLabel>(getEventLabel(Event(i, 0)));
+		if (tsLab && tsLab->getCreate() && !preds->contains(tsLab->getCreate()->getPos()))
+			tsLab->setCreate(nullptr);
+		auto *eLab = llvm::dyn_cast<ThreadFinishLabel>(
+			getEventLabel(Event(i, std::max(preds->getMax(i), 0))));
+		if (eLab && eLab->getParentJoin() &&
+		    !preds->contains(eLab->getParentJoin()->getPos()))
+			eLab->setParentJoin(nullptr);
+	}
+
+	/* Drop the cut accesses, and the locations that are no longer accessed */
+	for (auto addr : cutLocs) {
+		auto &loc = getLoc(addr);
+		loc.accesses.cutToStamp(stamp);
+		if (loc.accesses.reads.empty() && loc.accesses.writes.empty())
+			untrackLoc(loc);
+		else
+			repackCo(loc);
+	}
+
+	for (auto labIt = cutIt; labIt != insertionOrder.end();) {
 		if (preds->contains(labIt->getPos()))
 			++labIt;
 		else {
@@ -205,57 +352,6 @@ void ExecutionGraph::cutToStamp(Stamp stamp)
 		}
 	}
 
-	/* Remove any 'pointers' to events that will be removed */
-	for (auto i = 0U; i < getNumThreads(); i++) {
-		for (auto j = 0U; j <= preds->getMax(i); j++) {
-			auto *lab = getEventLabel(Event(i, j));
-			if (auto *wLab = llvm::dyn_cast<WriteLabel>(lab)) {
-				wLab->removeReader([&](ReadLabel &rLab) {
-					return !preds->contains(rLab.getPos());
-				});
-			}
-			if (auto *rLab = llvm::dyn_cast<ReadLabel>(lab)) {
-				if (rLab->getRf() && !preds->contains(rLab->getRf()->getPos()))
-					rLab->setRfNoCascade(nullptr);
-			}
-			if (auto *mLab = llvm::dyn_cast<MemAccessLabel>(lab)) {
-				if (mLab->getAlloc() && !preds->contains(mLab->getAlloc()))
-					mLab->setAlloc(nullptr);
-			}
-			if (auto *tsLab = llvm::dyn_cast<ThreadStartLabel>(lab)) {
-				if (tsLab->getCreate() &&
-				    !preds->contains(tsLab->getCreate()->getPos()))
-					tsLab->setCreate(nullptr);
-			}
-			if (auto *eLab = llvm::dyn_cast<ThreadFinishLabel>(lab)) {
-				if (eLab->getParentJoin() &&
-				    !preds->contains(eLab->getParentJoin()->getPos()))
-					eLab->setParentJoin(nullptr);
-			}
-			if (auto *dLab = llvm::dyn_cast<FreeLabel>(lab)) {
-				if (dLab->getAlloc() && !preds->contains(dLab->getAlloc()))
-					dLab->setAlloc(nullptr);
-			}
-			if (auto *aLab = llvm::dyn_cast<MallocLabel>(lab)) {
-				if (aLab->getFree() && !preds->contains(aLab->getFree()->getPos()))
-					aLab->setFree(nullptr);
-				aLab->removeAccess([&](MemAccessLabel &mLab) {
-					return !preds->contains(mLab.getPos());
-				});
-			}
-			if (auto *begLab = llvm::dyn_cast<MethodBeginLabel>(lab)) {
-				begLab->removePredNoCascade([&](auto *endLab) {
-					return !preds->contains(endLab->getPos());
-				});
-			}
-			if (auto *endLab = llvm::dyn_cast<MethodEndLabel>(lab)) {
-				endLab->removeSuccNoCascade([&](auto *begLab) {
-					return !preds->contains(begLab->getPos());
-				});
-			}
-		}
-	}
-
 	/* Restrict the graph according to the view (keeps begins around) */
 	for (auto i = 0U; i < getNumThreads(); i++) {
 		auto &thr = events[i];
@@ -281,10 +377,14 @@ void ExecutionGraph::cutToStamp(Stamp stamp)
 		}
 	}
 
-	/* Fix stamps */
-	resetStamp(0U);
-	for (auto &lab : labels())
+	/* Fix stamps (only the begins that were kept need new ones) */
+	auto fixIt = insertionOrder.end();
+	while (fixIt != insertionOrder.begin() && std::prev(fixIt)->getStamp() > stamp)
+		--fixIt;
+	resetStamp(fixIt == insertionOrder.begin() ? Stamp(0U) : std::prev(fixIt)->getStamp() + 1);
+	for (auto &lab : std::ranges::subrange(fixIt, insertionOrder.end()))
 		lab.setStamp(nextStamp());
+	cutViews(viewsCut, std::ranges::subrange(fixIt, insertionOrder.end()));
 }
 
 void ExecutionGraph::copyGraphUpTo(ExecutionGraph &other, const VectorClock &v) const
@@ -296,16 +396,41 @@ void ExecutionGraph::copyGraphUpTo(ExecutionGraph &other, const VectorClock &v)
 	 * Will clean up orphaned begins later. */
 	other.events.resize(getNumThreads());
 	other.poLists.resize(getNumThreads());
+
+	/* Clone the labels (skipping the initializer) into OTHER's region all
+	 * at once, in insertion order, so that cutting OTHER frees whole chunks */
+	auto isCopied = [&v](const EventLabel &lab) {
+		auto pos = lab.getPos();
+		return pos.index == 0 ? pos.thread != 0 : v.contains(pos);
+	};
+	auto numCopied = 0UL;
+	auto copiedBytes = 0UL;
+	for (const auto &lab : insertionOrder | std::views::filter(isCopied)) {
+		++numCopied;
+		copiedBytes += lab.getFootprint();
+	}
+	/* (Small graphs would not fill a good part of a chunk) */
+	auto useRegion = copiedBytes >= SlabAllocator::Region::getMinBytes();
+	if (useRegion)
+		other.labelRegion_.reserve(numCopied, copiedBytes);
+
+	std::vector<std::vector<std::unique_ptr<EventLabel>>> clones(getNumThreads());
+	for (auto i = 0u; i < getNumThreads(); i++)
+		clones[i].resize(std::max(v.getMax(i), 0) + 1);
+	for (const auto &lab : insertionOrder | std::views::filter(isCopied))
+		clones[lab.getThread()][lab.getIndex()] =
+			useRegion ? lab.clone(other.labelRegion_) : lab.clone();
+
 	for (auto i = 0u; i < getNumThreads(); i++) {
 		/* Skip the initializer */
 		if (i != 0)
-			other.addLabelToGraph(getEventLabel(Event(i, 0))->clone());
+			other.addLabelToGraph(std::move(clones[i][0]));
 		for (auto j = 1; j <= v.getMax(i); j++) {
 			if (!v.contains(Event(i, j))) {
 				other.addLabelToGraph(createHoleLabel(Event(i, j)));
 				continue;
 			}
-			auto *nLab = other.addLabelToGraph(getEventLabel(Event(i, j))->clone());
+			auto *nLab = other.addLabelToGraph(std::move(clones[i][j]));
 			if (auto *wLab = llvm::dyn_cast<WriteLabel>(nLab)) {
 				const_cast<WriteLabel *>(wLab)->removeReader([&v](ReadLabel &rLab) {
 					return !v.contains(rLab.getPos());
@@ -340,14 +465,17 @@ void ExecutionGraph::copyGraphUpTo(ExecutionGraph &other, const VectorClock &v)
 		}
 	}
 
-	/* Fix insertion order */
+	/* Fix insertion order (and copy the views along) */
 	other.insertionOrder.clear();
 	other.resetStamp(0);
+	other.viewStore_.reserve(viewStore_.capacity()); /* the copy will grow again */
 	for (const auto &lab : insertionOrder) {
 		/* Do not use v here because of trailing begins */
 		if (other.containsPos(lab.getPos())) {
-			other.insertionOrder.push_back(*other.getEventLabel(lab.getPos()));
-			other.getEventLabel(lab.getPos())->setStamp(other.nextStamp());
+			auto *oLab = other.getEventLabel(lab.getPos());
+			other.insertionOrder.push_back(*oLab);
+			oLab->setStamp(other.nextStamp());
+			other.appendViews(oLab, viewStore_);
 		}
 	}
 
@@ -445,28 +573,16 @@ void ExecutionGraph::copyGraphUpTo(ExecutionGraph &other, const VectorClock &v)
 	}
 
 	/* Finally, copy coherence info */
-	for (auto lIt = loc_begin(), lE = loc_end(); lIt != lE; ++lIt) {
-		for (auto sIt = lIt->second.begin(); sIt != lIt->second.end(); ++sIt)
-			if (v.contains(sIt->getPos())) {
-				other.getWriteLabel(sIt->getPos())
-					->addCo(other.co_max(sIt->getAddr()));
+	for (const auto &loc : locs()) {
+		for (const auto &sLab : loc.stores)
+			if (v.contains(sLab.getPos())) {
+				other.getWriteLabel(sLab.getPos())->addCo(other.co_max(loc.addr));
 			}
 	}
-	for (auto it = loc_begin(); it != loc_end(); ++it) {
-		auto &initRfs = getInitLabel()->initRfs;
-		for (auto rIt = initRfs.at(it->first).begin(); rIt != initRfs.at(it->first).end();
-		     ++rIt) {
-			if (v.contains(rIt->getPos())) {
-				other.addInitRfToLoc(other.getReadLabel(rIt->getPos()));
-			}
-		}
-	}
-	for (auto it = loc_begin(); it != loc_end(); ++it) {
-		auto &accesses = accessMap_.at(it->first);
-		for (auto rIt = accesses.begin(); rIt != accesses.end(); ++rIt) {
-			if (v.contains((*rIt)->getPos())) {
-				other.accessMap_[it->first].push_back(
-					other.getEventLabel((*rIt)->getPos()));
+	for (const auto &loc : locs()) {
+		for (const auto &rLab : loc.initRfs) {
+			if (v.contains(rLab.getPos())) {
+				other.addInitRfToLoc(other.getReadLabel(rLab.getPos()));
 			}
 		}
 	}
@@ -479,6 +595,43 @@ auto ExecutionGraph::getCopyUpTo(const VectorClock &v) const -> std::unique_ptr<
 	return og;
 }
 
+/************************************************************
+ ** Memory accounting
+ ***********************************************************/
+
+auto ExecutionGraph::getMemoryUsage() const -> std::size_t
+{
+	auto size = sizeof(*this);
+
+	size += events.capacity() * sizeof(Thread);
+	for (const auto &thr : events) {
+		size += thr.capacity() * sizeof(Thread::value_type);
+		for (const auto &lab : thr) {
+			/* (Labels in the region are accounted for below) */
+			if (!SlabAllocator::Region::contains(&*lab, lab->getFootprint()))
+				size += lab->getFootprint();
+			if (lab->hasPrefixView())
+				size += lab->getPrefixView().getFootprint();
+			size += lab->calculatedRels.capacity() * sizeof(VSet<Event>);
+			for (const auto &rel : lab->calculatedRels)
+				size += rel.getHeapSize();
+		}
+	}
+
+	size += labelRegion_.getMemoryUsage();
+	for (const auto &v : viewStore_)
+		size += v.getFootprint();
+	size += locIds_.getMemorySize();
+	size += locations_.capacity() * sizeof(Location);
+	for (const auto &loc : locations_) {
+		size += loc.coArray.capacity() * sizeof(WriteLabel *);
+		for (const auto *list : {&loc.accesses.reads, &loc.accesses.writes,
+					 &loc.accesses.frees})
+			size += list->capacity() * sizeof(EventLabel *);
+	}
+	return size;
+}
+
 /************************************************************
  ** Debugging methods
  ***********************************************************/
@@ -565,10 +718,10 @@ auto operator<<(llvm::raw_ostream &s, const ExecutionGraph &g) -> llvm::raw_ostr
 		s << g.getThreadSize(i) << " ";
 	s << "\n";
 
-	for (auto lIt = g.loc_begin(), lE = g.loc_end(); lIt != lE; ++lIt) {
-		s << lIt->first << ": ";
-		for (auto sIt = g.co_begin(lIt->first); sIt != g.co_end(lIt->first); ++sIt)
-			s << sIt->getPos() << " ";
+	for (const auto &loc : g.locs()) {
+		s << loc.addr << ": ";
+		for (const auto &sLab : loc.stores)
+			s << sLab.getPos() << " ";
 		s << "\n";
 	}
 	return s;
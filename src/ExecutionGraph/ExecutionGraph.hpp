@@ -19,8 +19,11 @@
 #include "ExecutionGraph/EventLabel.hpp"
 #include "ExecutionGraph/Stamp.hpp"
 #include "Support/Hash.hpp"
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/ADT/StringMap.h>
 
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <memory>
 #include <ranges>
@@ -45,9 +48,8 @@ public:
 	using Thread = std::vector<std::unique_ptr<EventLabel>>;
 	using ThreadList = std::vector<Thread>;
 	using StoreList = llvm::simple_ilist<WriteLabel>;
-	using LocMap = std::unordered_map<SAddr, StoreList>;
+	using ReaderList = CopyableIList<ReadLabel>;
 	using AccessVector = std::vector<EventLabel *>;
-	using AccessMap = std::unordered_map<SAddr, AccessVector>;
 	using InitValGetter = std::function<SVal(const AAccess &)>;
 	using PoList = llvm::simple_ilist<EventLabel, llvm::ilist_tag<po_tag>>;
 	using PoLists = std::vector<PoList>;
@@ -60,7 +62,6 @@ public:
 		poLists.emplace_back();
 		auto *iLab = addLabelToGraph(InitLabel::create());
 		iLab->setCalculated({{}});
-		iLab->setViews({{}});
 		iLab->setPrefixView(std::make_unique<View>());
 	}
 
@@ -78,9 +79,6 @@ public:
 	using reverse_iterator = ThreadList::reverse_iterator;
 	using const_reverse_iterator = ThreadList::const_reverse_iterator;
 
-	using loc_iterator = LocMap::iterator;
-	using const_loc_iterator = LocMap::const_iterator;
-
 	using label_iterator = IoList::iterator;
 	using const_label_iterator = IoList::const_iterator;
 	using reverse_label_iterator = IoList::reverse_iterator;
@@ -91,8 +89,8 @@ public:
 	using reverse_co_iterator = StoreList::reverse_iterator;
 	using const_reverse_co_iterator = StoreList::const_reverse_iterator;
 
-	using initrf_iterator = InitLabel::rf_iterator;
-	using const_initrf_iterator = InitLabel::const_rf_iterator;
+	using initrf_iterator = ReaderList::iterator;
+	using const_initrf_iterator = ReaderList::const_iterator;
 
 	using po_iterator = PoList::iterator;
 	using const_po_iterator = PoList::const_iterator;
@@ -152,12 +150,12 @@ public:
 	}
 
 	/* Returns the label in the previous position of E.
-	 * Returns nullptr if E is the first event of a thread */
+	 * Returns nullptr if E is the first event of a thread.
+	 * (Uses the packed thread arrays instead of the po-lists) */
 	auto po_imm_pred(const EventLabel *lab) const -> const EventLabel *
 	{
-		auto labIt = const_po_iterator(lab);
-		auto begIt = poLists[lab->getThread()].begin();
-		return labIt == begIt ? nullptr : &*--labIt;
+		auto idx = lab->getIndex();
+		return idx == 0 ? nullptr : events[lab->getThread()][idx - 1].get();
 	}
 	auto po_imm_pred(EventLabel *lab) -> EventLabel *
 	{
@@ -169,9 +167,9 @@ public:
 	 * Returns nullptr if E is the last event of a thread */
 	auto po_imm_succ(const EventLabel *lab) const -> const EventLabel *
 	{
-		auto rLabIt = const_reverse_po_iterator(lab);
-		auto rBegIt = poLists[lab->getThread()].rbegin();
-		return rLabIt == rBegIt ? nullptr : &*--rLabIt;
+		const auto &thr = events[lab->getThread()];
+		auto idx = static_cast<size_t>(lab->getIndex()) + 1;
+		return idx == thr.size() ? nullptr : thr[idx].get();
 	}
 	auto po_imm_succ(EventLabel *lab) -> EventLabel *
 	{
@@ -179,59 +177,66 @@ public:
 			static_cast<const ExecutionGraph &>(*this).po_imm_succ(lab));
 	}
 
-	auto loc_begin() -> loc_iterator { return coherence.begin(); }
-	auto loc_begin() const -> const_loc_iterator { return coherence.begin(); };
-	auto loc_end() -> loc_iterator { return coherence.end(); }
-	auto loc_end() const -> const_loc_iterator { return coherence.end(); }
+	/* The locations currently in the graph */
+	auto locs() const
+	{
+		return std::views::all(locations_) |
+		       std::views::filter([](auto &loc) { return loc.tracked; });
+	}
 
-	auto co_begin(SAddr addr) -> co_iterator { return coherence[addr].begin(); }
-	auto co_begin(SAddr addr) const -> const_co_iterator { return coherence.at(addr).begin(); };
-	auto co_end(SAddr addr) -> co_iterator { return coherence[addr].end(); }
-	auto co_end(SAddr addr) const -> const_co_iterator { return coherence.at(addr).end(); }
-	auto co(SAddr addr) { return std::views::all(coherence[addr]); }
-	auto co(SAddr addr) const { return std::views::all(coherence.at(addr)); }
+	auto co_begin(SAddr addr) -> co_iterator { return getLoc(addr).stores.begin(); }
+	auto co_begin(SAddr addr) const -> const_co_iterator { return getLoc(addr).stores.begin(); };
+	auto co_end(SAddr addr) -> co_iterator { return getLoc(addr).stores.end(); }
+	auto co_end(SAddr addr) const -> const_co_iterator { return getLoc(addr).stores.end(); }
+	auto co(SAddr addr) { return std::views::all(getLoc(addr).stores); }
+	auto co(SAddr addr) const { return std::views::all(getLoc(addr).stores); }
 
-	auto co_rbegin(SAddr addr) -> reverse_co_iterator { return coherence[addr].rbegin(); }
+	auto co_rbegin(SAddr addr) -> reverse_co_iterator { return getLoc(addr).stores.rbegin(); }
 	auto co_rbegin(SAddr addr) const -> const_reverse_co_iterator
 	{
-		return coherence.at(addr).rbegin();
+		return getLoc(addr).stores.rbegin();
 	};
-	auto co_rend(SAddr addr) -> reverse_co_iterator { return coherence[addr].rend(); }
+	auto co_rend(SAddr addr) -> reverse_co_iterator { return getLoc(addr).stores.rend(); }
 	auto co_rend(SAddr addr) const -> const_reverse_co_iterator
 	{
-		return coherence.at(addr).rend();
+		return getLoc(addr).stores.rend();
 	}
-	auto rco(SAddr addr) { return std::views::all(coherence[addr]) | std::views::reverse; }
+	auto rco(SAddr addr) { return std::views::all(getLoc(addr).stores) | std::views::reverse; }
 	auto rco(SAddr addr) const
 	{
-		return std::views::all(coherence.at(addr)) | std::views::reverse;
+		return std::views::all(getLoc(addr).stores) | std::views::reverse;
 	}
 
-	auto init_rf_begin(SAddr addr) -> initrf_iterator { return getInitLabel()->rf_begin(addr); }
+	auto init_rf_begin(SAddr addr) -> initrf_iterator { return getLoc(addr).initRfs.begin(); }
 	auto init_rf_begin(SAddr addr) const -> const_initrf_iterator
 	{
-		return getInitLabel()->rf_begin(addr);
+		return getLoc(addr).initRfs.begin();
 	};
-	auto init_rf_end(SAddr addr) -> initrf_iterator { return getInitLabel()->rf_end(addr); }
+	auto init_rf_end(SAddr addr) -> initrf_iterator { return getLoc(addr).initRfs.end(); }
 	auto init_rf_end(SAddr addr) const -> const_initrf_iterator
 	{
-		return getInitLabel()->rf_end(addr);
+		return getLoc(addr).initRfs.end();
 	}
+	auto init_rfs(SAddr addr) { return std::views::all(getLoc(addr).initRfs); }
+	auto init_rfs(SAddr addr) const { return std::views::all(getLoc(addr).initRfs); }
 
 	auto co_succ_begin(WriteLabel *lab) -> co_iterator { return ++co_iterator(lab); }
 	auto co_succ_begin(const WriteLabel *lab) const -> const_co_iterator
 	{
 		return ++const_co_iterator(lab);
 	}
-	auto co_succ_end(WriteLabel *lab) -> co_iterator { return co_end(lab->getAddr()); }
+	auto co_succ_end(WriteLabel *lab) -> co_iterator { return getLoc(lab).stores.end(); }
 	auto co_succ_end(const WriteLabel *lab) const -> const_co_iterator
 	{
-		return co_end(lab->getAddr());
+		return getLoc(lab).stores.end();
 	}
+	/* The immediate co-neighbours are looked up in the packed
+	 * coherence order (no need to find the location's list) */
 	auto co_imm_succ(const WriteLabel *lab) const -> const WriteLabel *
 	{
-		auto it = co_succ_begin(lab);
-		return it == co_succ_end(lab) ? nullptr : &*it;
+		const auto &co = getLoc(lab).coArray;
+		auto idx = lab->coIdx + 1;
+		return idx == co.size() ? nullptr : co[idx];
 	}
 
 	auto co_pred_begin(WriteLabel *lab) -> reverse_co_iterator
@@ -242,15 +247,15 @@ public:
 	{
 		return ++const_reverse_co_iterator(lab);
 	}
-	auto co_pred_end(WriteLabel *lab) -> reverse_co_iterator { return co_rend(lab->getAddr()); }
+	auto co_pred_end(WriteLabel *lab) -> reverse_co_iterator { return getLoc(lab).stores.rend(); }
 	auto co_pred_end(const WriteLabel *lab) const -> const_reverse_co_iterator
 	{
-		return co_rend(lab->getAddr());
+		return getLoc(lab).stores.rend();
 	}
 	auto co_imm_pred(const WriteLabel *lab) const -> const WriteLabel *
 	{
-		auto it = co_pred_begin(lab);
-		return it == co_pred_end(lab) ? nullptr : &*(it);
+		const auto &co = getLoc(lab).coArray;
+		return lab->coIdx == 0 ? nullptr : co[lab->coIdx - 1];
 	}
 	auto co_imm_pred(WriteLabel *lab) -> WriteLabel *
 	{
@@ -260,8 +265,8 @@ public:
 
 	auto co_max(SAddr addr) const -> const EventLabel *
 	{
-		return co_begin(addr) == co_end(addr) ? (EventLabel *)getInitLabel()
-						      : (EventLabel *)&*co_rbegin(addr);
+		const auto &co = getLoc(addr).coArray;
+		return co.empty() ? (EventLabel *)getInitLabel() : (EventLabel *)co.back();
 	}
 	auto co_max(SAddr addr) -> EventLabel *
 	{
@@ -272,63 +277,73 @@ public:
 	auto fr_succ_begin(ReadLabel *rLab) -> co_iterator
 	{
 		auto *wLab = llvm::dyn_cast<WriteLabel>(rLab->getRf());
-		return wLab ? co_succ_begin(wLab) : co_begin(rLab->getAddr());
+		return wLab ? co_succ_begin(wLab) : getLoc(rLab).stores.begin();
 	}
 	auto fr_succ_begin(const ReadLabel *rLab) const -> const_co_iterator
 	{
 		auto *wLab = llvm::dyn_cast<WriteLabel>(rLab->getRf());
-		return wLab ? co_succ_begin(wLab) : co_begin(rLab->getAddr());
+		return wLab ? co_succ_begin(wLab) : getLoc(rLab).stores.begin();
 	}
-	auto fr_succ_end(ReadLabel *rLab) -> co_iterator { return co_end(rLab->getAddr()); }
+	auto fr_succ_end(ReadLabel *rLab) -> co_iterator { return getLoc(rLab).stores.end(); }
 	auto fr_succ_end(const ReadLabel *rLab) const -> const_co_iterator
 	{
-		return co_end(rLab->getAddr());
+		return getLoc(rLab).stores.end();
 	}
 	auto fr_imm_succ(const ReadLabel *rLab) const -> const WriteLabel *
 	{
-		auto it = fr_succ_begin(rLab);
-		return it == fr_succ_end(rLab) ? nullptr : &*it;
+		if (auto *wLab = llvm::dyn_cast<WriteLabel>(rLab->getRf()))
+			return co_imm_succ(wLab);
+		const auto &co = getLoc(rLab).coArray;
+		return co.empty() ? nullptr : co.front();
 	}
 
 	auto fr_imm_pred_begin(WriteLabel *wLab) -> WriteLabel::rf_iterator
 	{
-		return co_pred_begin(wLab) == co_pred_end(wLab)
-			       ? init_rf_begin(wLab->getAddr())
-			       : (*co_pred_begin(wLab)).readers_begin();
+		auto *pLab = co_imm_pred(wLab);
+		return pLab ? pLab->readers_begin() : getLoc(wLab).initRfs.begin();
 	}
 	auto fr_imm_pred_begin(const WriteLabel *wLab) const -> WriteLabel::const_rf_iterator
 	{
-		return co_pred_begin(wLab) == co_pred_end(wLab)
-			       ? init_rf_begin(wLab->getAddr())
-			       : (*co_pred_begin(wLab)).readers_begin();
+		const auto *pLab = co_imm_pred(wLab);
+		return pLab ? pLab->readers_begin() : getLoc(wLab).initRfs.begin();
 	}
 	auto fr_imm_pred_end(WriteLabel *wLab) -> WriteLabel::rf_iterator
 	{
-		return co_pred_begin(wLab) == co_pred_end(wLab)
-			       ? init_rf_end(wLab->getAddr())
-			       : (*co_pred_begin(wLab)).readers_end();
+		auto *pLab = co_imm_pred(wLab);
+		return pLab ? pLab->readers_end() : getLoc(wLab).initRfs.end();
 	}
 	auto fr_imm_pred_end(const WriteLabel *wLab) const -> WriteLabel::const_rf_iterator
 	{
-		return co_pred_begin(wLab) == co_pred_end(wLab)
-			       ? init_rf_end(wLab->getAddr())
-			       : (*co_pred_begin(wLab)).readers_end();
+		const auto *pLab = co_imm_pred(wLab);
+		return pLab ? pLab->readers_end() : getLoc(wLab).initRfs.end();
 	}
 
-	auto samelocs(const EventLabel *lab) const
+	/* Turns a list of accesses into a range of the accesses other than LAB */
+	static auto sameLocsExcept(const EventLabel *lab)
 	{
-		auto isSameLabel = [lab](const EventLabel *oLab) { return lab != oLab; };
-		auto cIndirect = [](auto *lab) -> EventLabel & { return *lab; };
-		static const std::vector<EventLabel *> accessSentinelVector;
+		return std::views::filter([lab](const EventLabel *oLab) { return lab != oLab; }) |
+		       std::views::transform([](auto *oLab) -> EventLabel & { return *oLab; });
+	}
 
-		if (llvm::isa<MemAccessLabel>(lab))
-			return accessMap_.at(llvm::cast<MemAccessLabel>(lab)->getAddr()) |
-			       std::views::filter(isSameLabel) | std::views::transform(cIndirect);
-		if (llvm::isa<FreeLabel>(lab))
-			return accessMap_.at(llvm::cast<FreeLabel>(lab)->getFreedAddr()) |
-			       std::views::filter(isSameLabel) | std::views::transform(cIndirect);
-		return accessSentinelVector | std::views::filter(isSameLabel) |
-		       std::views::transform(cIndirect);
+	/* The accesses to the location of LAB (other than LAB itself) */
+	auto samelocs(const EventLabel *lab) const
+	{
+		const auto &index = getAccessIndex(lab);
+		return std::array{&index.reads, &index.writes, &index.frees} |
+		       std::views::transform([](auto *accesses) -> auto & { return *accesses; }) |
+		       std::views::join | sameLocsExcept(lab);
+	}
+	auto samelocs_reads(const EventLabel *lab) const
+	{
+		return getAccessIndex(lab).reads | sameLocsExcept(lab);
+	}
+	auto samelocs_writes(const EventLabel *lab) const
+	{
+		return getAccessIndex(lab).writes | sameLocsExcept(lab);
+	}
+	auto samelocs_frees(const EventLabel *lab) const
+	{
+		return getAccessIndex(lab).frees | sameLocsExcept(lab);
 	}
 
 	/* Thread-related methods */
@@ -457,7 +472,11 @@ public:
 
 	void setInitValGetter(InitValGetter f) { initValGetter_ = std::move(f); }
 
-	auto containsLoc(SAddr addr) const -> bool { return coherence.contains(addr); }
+	auto containsLoc(SAddr addr) const -> bool
+	{
+		auto it = locIds_.find(addr.get());
+		return it != locIds_.end() && locations_[it->second].tracked;
+	}
 
 	auto isLocEmpty(SAddr addr) const -> bool { return co_begin(addr) == co_end(addr); }
 
@@ -521,12 +540,198 @@ public:
 		return getCopyUpTo(*getViewFromStamp(getMaxStamp()));
 	}
 
+	/* Serialization */
+
+	/* Writes the graph in a binary format (see GraphSerialization.cpp) */
+	void serialize(ByteWriter &out) const;
+
+	/* Reads a graph written by serialize(). The graph will use F
+	 * to obtain the initial values of memory locations */
+	static auto deserialize(ByteReader &in, InitValGetter f) -> std::unique_ptr<ExecutionGraph>;
+
+	/* Writes the graph to FILE. Returns false if FILE cannot be written */
+	auto save(const std::string &file) const -> bool;
+
+	/* Reads a graph written by save() from FILE.
+	 * Returns nullptr if FILE cannot be read */
+	static auto load(const std::string &file, InitValGetter f) -> std::unique_ptr<ExecutionGraph>;
+
+	/* Memory accounting */
+
+	/* Returns an estimate of the bytes owned by the graph (labels along
+	 * with their prefix views and calculated relations, views,
+	 * per-location information) */
+	auto getMemoryUsage() const -> std::size_t;
+
 	/* Overloaded operators */
 	friend auto operator<<(llvm::raw_ostream &s, const ExecutionGraph &g)
 		-> llvm::raw_ostream &;
 
 protected:
+	friend class EventLabel;
 	friend class WriteLabel;
+	friend class InitLabel;
+
+	/* The accesses (no allocs) to a location, split by kind.
+	 * Each list is ordered by stamp, so that cutting the graph
+	 * only truncates it */
+	struct AccessIndex {
+		AccessVector reads;
+		AccessVector writes;
+		AccessVector frees;
+
+		auto getList(const EventLabel *lab) -> AccessVector &
+		{
+			if (llvm::isa<ReadLabel>(lab))
+				return reads;
+			return llvm::isa<WriteLabel>(lab) ? writes : frees;
+		}
+
+		/* Adds LAB, which is normally the latest access */
+		void add(EventLabel *lab)
+		{
+			auto &list = getList(lab);
+			if (list.empty() || list.back()->getStamp() < lab->getStamp()) {
+				list.push_back(lab);
+				return;
+			}
+			auto it = std::ranges::upper_bound(list, lab->getStamp(), std::less<>{},
+							   [](auto *oLab) { return oLab->getStamp(); });
+			list.insert(it, lab);
+		}
+
+		void remove(EventLabel *lab)
+		{
+			auto &list = getList(lab);
+			auto it = std::find(list.rbegin(), list.rend(), lab);
+			if (it != list.rend())
+				list.erase(std::next(it).base());
+		}
+
+		/* Removes all accesses with stamps larger than STAMP */
+		void cutToStamp(Stamp stamp)
+		{
+			for (auto *list : {&reads, &writes, &frees}) {
+				while (!list->empty() && list->back()->getStamp() > stamp)
+					list->pop_back();
+			}
+		}
+
+		/* Restores the ordering after the stamps have been changed */
+		void sortByStamp()
+		{
+			for (auto *list : {&reads, &writes, &frees})
+				std::ranges::sort(*list, std::less<>{},
+						  [](auto *lab) { return lab->getStamp(); });
+		}
+
+		template <typename F> void removeIf(F cond)
+		{
+			std::erase_if(reads, cond);
+			std::erase_if(writes, cond);
+			std::erase_if(frees, cond);
+		}
+
+		void clear()
+		{
+			reads.clear();
+			writes.clear();
+			frees.clear();
+		}
+	};
+
+	/* Information kept for each memory location accessed in the graph */
+	struct Location {
+		Location(SAddr addr) : addr(addr) {}
+
+		SAddr addr;
+
+		/* Whether the location is (still) accessed in the graph.
+		 * Locations are never removed from the table, so that
+		 * their IDs remain stable */
+		bool tracked = false;
+
+		/* The stores to the location, in coherence order */
+		StoreList stores;
+
+		/* The same stores, packed (each store knows its index; see repackCo()) */
+		std::vector<WriteLabel *> coArray;
+
+		/* The reads reading from the initializer */
+		ReaderList initRfs;
+
+		/* All accesses (no allocs) to the location */
+		AccessIndex accesses;
+	};
+
+	/* Returns the (dense) ID of ADDR, assigning a new one if necessary */
+	auto getLocId(SAddr addr) -> unsigned
+	{
+		auto [it, inserted] = locIds_.try_emplace(addr.get(), locations_.size());
+		if (inserted)
+			locations_.emplace_back(addr);
+		return it->second;
+	}
+
+	/* Returns the information for ADDR, which is tracked after the call */
+	auto getLoc(SAddr addr) -> Location &
+	{
+		auto &loc = locations_[getLocId(addr)];
+		loc.tracked = true;
+		return loc;
+	}
+	auto getLoc(SAddr addr) const -> const Location &
+	{
+		auto it = locIds_.find(addr.get());
+		BUG_ON(it == locIds_.end());
+		return locations_[it->second];
+	}
+
+	/* Returns the information for the location MLAB accesses, without
+	 * looking up its address (MLAB needs to be part of the graph) */
+	auto getLoc(const MemAccessLabel *mLab) -> Location &
+	{
+		BUG_ON(mLab->getParent() != this);
+		return locations_[mLab->locId];
+	}
+	auto getLoc(const MemAccessLabel *mLab) const -> const Location &
+	{
+		BUG_ON(mLab->getParent() != this);
+		return locations_[mLab->locId];
+	}
+
+	/* Returns the accesses to the location of LAB (if any) */
+	auto getAccessIndex(const EventLabel *lab) const -> const AccessIndex &
+	{
+		static const AccessIndex noAccesses;
+
+		if (auto *mLab = llvm::dyn_cast<MemAccessLabel>(lab))
+			return getLoc(mLab).accesses;
+		if (auto *dLab = llvm::dyn_cast<FreeLabel>(lab))
+			return getLoc(dLab->getFreedAddr()).accesses;
+		return noAccesses;
+	}
+
+	/* Inserts WLAB in the coherence order of its location,
+	 * right after PREDLAB (or first, if PREDLAB is null) */
+	void addToCo(WriteLabel *wLab, WriteLabel *predLab);
+
+	/* Removes WLAB from the coherence order of its location */
+	void removeFromCo(WriteLabel *wLab);
+
+	/* Rebuilds the packed coherence order of LOC from its store list
+	 * (e.g., after removing multiple stores) */
+	void repackCo(Location &loc);
+
+	/* Stops tracking LOC (e.g., because all its accesses were cut) */
+	static void untrackLoc(Location &loc)
+	{
+		loc.tracked = false;
+		loc.stores.clear();
+		loc.coArray.clear();
+		loc.initRfs.clear();
+		loc.accesses.clear();
+	}
 
 	static auto indirect(const std::unique_ptr<EventLabel> &ptr) -> EventLabel &
 	{
@@ -555,37 +760,84 @@ protected:
 
 	void addInitRfToLoc(ReadLabel *rLab) { getInitLabel()->addReader(rLab); }
 
-	void removeInitRfToLoc(ReadLabel *rLab)
+	void removeInitRfToLoc(ReadLabel *rLab) { getInitLabel()->removeReader(rLab); }
+
+	void removeAfter(const VectorClock &preds);
+
+	/* Removes any 'pointers' from the labels in PREDS to LAB, which is
+	 * about to be cut. Collects the locations LAB accesses in CUTLOCS */
+	void unlinkCutLabel(EventLabel *lab, const VectorClock &preds, VSet<SAddr> &cutLocs);
+
+	/* The calculated views of each label are consecutive entries of
+	 * viewStore_. In a plain graph, labels are laid out in stamp order,
+	 * so that cutting the graph truncates the store */
+
+	/* Returns the I-th calculated view of LAB */
+	auto getView(const EventLabel *lab, size_t i) const -> const View &
 	{
-		getInitLabel()->removeReader(rLab->getAddr(),
-					     [&](auto &lab) { return &lab == rLab; });
+		BUG_ON(i >= lab->numViews);
+		return viewStore_[*lab->viewsOffset + i];
 	}
 
-	void removeAfter(const VectorClock &preds);
+	/* Returns the number of calculated views of LAB */
+	auto getNumViews(const EventLabel *lab) const -> unsigned { return lab->numViews; }
+
+	/* Appends V to the calculated views of LAB */
+	void addView(EventLabel *lab, View &&v);
+
+	/* Copies the views of LAB from STORE (which starts at offset BASE)
+	 * to the end of the store */
+	void appendViews(EventLabel *lab, const std::vector<View> &store, unsigned base = 0);
+
+	/* Like appendViews(), but moves the views out of STORE */
+	void moveViews(EventLabel *lab, std::vector<View> &store, unsigned base = 0);
+
+	/* Drops all views with offsets greater than or equal to OFFSET
+	 * (except for the ones of KEPT, which are moved) */
+	template <typename R> void cutViews(unsigned offset, R &&kept)
+	{
+		if (offset >= viewStore_.size())
+			return;
+
+		std::vector<View> tail(std::make_move_iterator(viewStore_.begin() + offset),
+				      std::make_move_iterator(viewStore_.end()));
+		viewStore_.erase(viewStore_.begin() + offset, viewStore_.end());
+		for (auto &lab : kept)
+			moveViews(&lab, tail, offset);
+	}
 
 	static auto createHoleLabel(Event pos) -> std::unique_ptr<EmptyLabel>
 	{
 		auto lab = EmptyLabel::create(pos);
-		lab->setViews({{}});
 		lab->setCalculated({{}});
 		return lab;
 	}
 
+	/* The labels cloned into this graph by copyGraphUpTo(), in insertion
+	 * order. (Declared before the labels, so that it outlives them) */
+	SlabAllocator::Region labelRegion_;
+
 	/* A collection of threads and the events for each threads */
 	ThreadList events;
 
 	/* The next available timestamp */
 	Stamp timestamp = 0;
 
-	LocMap coherence;
+	/* Maps addresses to location IDs */
+	llvm::DenseMap<SAddr::Width, unsigned> locIds_;
+
+	/* Per-location information, indexed by location ID */
+	std::vector<Location> locations_;
+
+	/* The calculated views of all labels (see getView()). Adding views
+	 * may move the others, so references to views must not be held across
+	 * calls to addView() */
+	std::vector<View> viewStore_;
 
 	IoList insertionOrder;
 
 	PoLists poLists{};
 
-	/* XXX: Temporary map; eventually remove */
-	AccessMap accessMap_;
-
 	/* Pers: The ID of the recovery routine.
 	 * It should be -1 if not in recovery mode, or have the
 	 * value of the recovery routine otherwise. */
@@ -534,6 +534,18 @@ inline const_fr_inv_range fr_imm_preds(const ExecutionGraph &G, const EventLabel
  ******************************************************************************/
 
 inline auto samelocs(const ExecutionGraph &G, const EventLabel *lab) { return G.samelocs(lab); }
+inline auto samelocs_reads(const ExecutionGraph &G, const EventLabel *lab)
+{
+	return G.samelocs_reads(lab);
+}
+inline auto samelocs_writes(const ExecutionGraph &G, const EventLabel *lab)
+{
+	return G.samelocs_writes(lab);
+}
+inline auto samelocs_frees(const ExecutionGraph &G, const EventLabel *lab)
+{
+	return G.samelocs_frees(lab);
+}
 
 /*******************************************************************************
  **                         alloc-iteration utilities
@@ -0,0 +1,918 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+/*
+ * Binary (de)serialization of execution graphs.
+ *
+ * Labels are written in insertion order, each along with its position,
+ * its graph-related information (stamp, saved views, etc) and the
+ * information that is specific to its kind. Pointers between labels
+ * (rf, allocation info, etc) are written as positions and are restored
+ * once all labels have been placed in the new graph, similarly to what
+ * copyGraphUpTo() does. All orders that might affect the exploration
+ * (insertion order, co, readers lists) are preserved.
+ *
+ * The saved views and relations of each label are always written. The
+ * consistency checkers calculate them once, when the label is added, over
+ * the graph as it was at that point; they cannot be recalculated from the
+ * complete graph.
+ *
+ * Files written by save() start with a magic string, followed by the
+ * serialized graph; they are mapped in memory (rather than read) when
+ * loaded, and the graph is decoded directly from the mapping. Integers
+ * are varint-encoded, so the graph is decoded, not used in place.
+ */
+
+#include "ExecutionGraph/DepExecutionGraph.hpp"
+#include "ExecutionGraph/ExecutionGraph.hpp"
+#include "Support/Serialization.hpp"
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <array>
+#include <map>
+#include <mutex>
+
+namespace {
+
+constexpr std::uint64_t GRAPH_FORMAT_VERSION = 4;
+
+constexpr llvm::StringLiteral GRAPH_FILE_MAGIC = "GENMCEG\n";
+
+enum class GraphType : std::uint8_t { Plain, Dep };
+
+using AnnotID = ModuleID::ID;
+using Expr = Annotation::Expr;
+
+/** Pointers of a label that need to be restored after all labels are in place */
+struct LabelRefs {
+	EventLabel *lab{};
+	std::optional<Event> rf;
+	std::optional<Event> alloc;
+	std::optional<Event> create;
+	std::optional<Event> parentJoin;
+	std::optional<Event> free;
+
+	/* Readers, accesses, or linearization preds/succs, depending on the kind */
+	std::vector<Event> related;
+};
+
+void writeOptPos(ByteWriter &out, const EventLabel *lab)
+{
+	out.writeBool(lab != nullptr);
+	if (lab)
+		lab->getPos().serialize(out);
+}
+
+auto readOptPos(ByteReader &in) -> std::optional<Event>
+{
+	if (!in.readBool())
+		return std::nullopt;
+	return Event::deserialize(in);
+}
+
+template <typename R> void writePosList(ByteWriter &out, R &&labs)
+{
+	out.writeU64(std::distance(labs.begin(), labs.end()));
+	for (const auto &lab : labs) {
+		if constexpr (std::is_pointer_v<std::remove_cvref_t<decltype(lab)>>)
+			lab->getPos().serialize(out);
+		else
+			lab.getPos().serialize(out);
+	}
+}
+
+/** Returns the label of type T at position E of G, or exits if there is none */
+template <typename T = EventLabel> auto getLabelAt(ExecutionGraph &g, Event e) -> T *
+{
+	auto *lab = g.containsPos(e) ? llvm::dyn_cast<T>(g.getEventLabel(e)) : nullptr;
+	ERROR_ON(!lab, "Malformed serialized graph (invalid reference)!\n");
+	return lab;
+}
+
+auto readPosList(ByteReader &in) -> std::vector<Event>
+{
+	std::vector<Event> result;
+	for (auto n = in.readU64(); n > 0; n--)
+		result.push_back(Event::deserialize(in));
+	return result;
+}
+
+void writeEventSet(ByteWriter &out, const VSet<Event> &es)
+{
+	out.writeU64(es.size());
+	for (const auto &e : es)
+		e.serialize(out);
+}
+
+auto readEventSet(ByteReader &in) -> VSet<Event>
+{
+	VSet<Event> result;
+	for (auto n = in.readU64(); n > 0; n--)
+		result.insert(Event::deserialize(in));
+	return result;
+}
+
+void writeDepInfo(ByteWriter &out, const DepInfo &dep)
+{
+	out.writeU64(std::distance(dep.begin(), dep.end()));
+	for (const auto &e : dep)
+		e.serialize(out);
+}
+
+auto readDepInfo(ByteReader &in) -> DepInfo
+{
+	DepInfo result;
+	for (auto n = in.readU64(); n > 0; n--)
+		result.update(DepInfo(Event::deserialize(in)));
+	return result;
+}
+
+void writeDeps(ByteWriter &out, const EventDeps &deps)
+{
+	writeDepInfo(out, deps.addr);
+	writeDepInfo(out, deps.data);
+	writeDepInfo(out, deps.ctrl);
+	writeDepInfo(out, deps.addrPo);
+	writeDepInfo(out, deps.cas);
+}
+
+auto readDeps(ByteReader &in) -> EventDeps
+{
+	EventDeps deps;
+	deps.addr = readDepInfo(in);
+	deps.data = readDepInfo(in);
+	deps.ctrl = readDepInfo(in);
+	deps.addrPo = readDepInfo(in);
+	deps.cas = readDepInfo(in);
+	return deps;
+}
+
+void writeThreadInfo(ByteWriter &out, const ThreadInfo &info)
+{
+	out.writeS64(info.id);
+	out.writeS64(info.parentId);
+	out.writeU64(info.funId);
+	out.writeU64(info.arg.get());
+	out.writeS64(info.symmId);
+}
+
+auto readThreadInfo(ByteReader &in) -> ThreadInfo
+{
+	ThreadInfo info;
+	info.id = static_cast<int>(in.readS64());
+	info.parentId = static_cast<int>(in.readS64());
+	info.funId = static_cast<unsigned>(in.readU64());
+	info.arg = SVal(in.readU64());
+	info.symmId = static_cast<int>(in.readS64());
+	return info;
+}
+
+void writeExpr(ByteWriter &out, const Expr &e)
+{
+	out.writeEnum(e.getKind());
+	out.writeU64(e.getWidth());
+	if (const auto *ce = llvm::dyn_cast<ConcreteExpr<AnnotID>>(&e)) {
+		out.writeU64(ce->getValue().get());
+		return;
+	}
+	if (const auto *re = llvm::dyn_cast<RegisterExpr<AnnotID>>(&e)) {
+		out.writeU64(re->getRegister());
+		out.writeString(re->getName());
+		return;
+	}
+	out.writeU64(e.getNumKids());
+	for (auto i = 0U; i < e.getNumKids(); i++)
+		writeExpr(out, *e.getKid(i));
+}
+
+auto readExpr(ByteReader &in) -> std::unique_ptr<Expr>
+{
+	auto kind = in.readEnum<Expr::Kind>();
+	auto width = static_cast<Expr::Width>(in.readU64());
+	if (kind == Expr::Concrete)
+		return ConcreteExpr<AnnotID>::create(width, SVal(in.readU64()));
+	if (kind == Expr::Register) {
+		auto reg = static_cast<AnnotID>(in.readU64());
+		auto name = in.readString();
+		return RegisterExpr<AnnotID>::create(width, reg, name);
+	}
+
+	std::vector<std::unique_ptr<Expr>> kids;
+	for (auto n = in.readU64(); n > 0; n--)
+		kids.push_back(readExpr(in));
+
+	auto expectKids = [&](size_t n) {
+		ERROR_ON(kids.size() != n, "Malformed serialized annotation!\n");
+	};
+
+	switch (kind) {
+	case Expr::Select:
+		expectKids(3);
+		return SelectExpr<AnnotID>::create(width, std::move(kids[0]), std::move(kids[1]),
+						   std::move(kids[2]));
+	case Expr::Conjunction:
+		ERROR_ON(kids.empty(), "Malformed serialized annotation!\n");
+		return ConjunctionExpr<AnnotID>::create(std::move(kids));
+	case Expr::Disjunction:
+		ERROR_ON(kids.empty(), "Malformed serialized annotation!\n");
+		return DisjunctionExpr<AnnotID>::create(std::move(kids));
+	case Expr::Not:
+		expectKids(1);
+		return NotExpr<AnnotID>::create(std::move(kids[0]));
+#define HANDLE_CAST(_kind)                                                                         \
+	case Expr::_kind:                                                                          \
+		expectKids(1);                                                                     \
+		return _kind##Expr<AnnotID>::create(width, std::move(kids[0]));
+		HANDLE_CAST(ZExt)
+		HANDLE_CAST(SExt)
+		HANDLE_CAST(Trunc)
+#undef HANDLE_CAST
+#define HANDLE_ARITHMETIC(_kind)                                                                   \
+	case Expr::_kind:                                                                          \
+		expectKids(2);                                                                     \
+		return _kind##Expr<AnnotID>::create(width, std::move(kids[0]), std::move(kids[1]));
+		HANDLE_ARITHMETIC(Add)
+		HANDLE_ARITHMETIC(Sub)
+		HANDLE_ARITHMETIC(Mul)
+		HANDLE_ARITHMETIC(UDiv)
+		HANDLE_ARITHMETIC(SDiv)
+		HANDLE_ARITHMETIC(URem)
+		HANDLE_ARITHMETIC(SRem)
+		HANDLE_ARITHMETIC(And)
+		HANDLE_ARITHMETIC(Or)
+		HANDLE_ARITHMETIC(Xor)
+		HANDLE_ARITHMETIC(Shl)
+		HANDLE_ARITHMETIC(LShr)
+		HANDLE_ARITHMETIC(AShr)
+#undef HANDLE_ARITHMETIC
+#define HANDLE_CMP(_kind)                                                                          \
+	case Expr::_kind:                                                                          \
+		expectKids(2);                                                                     \
+		return _kind##Expr<AnnotID>::create(std::move(kids[0]), std::move(kids[1]));
+		HANDLE_CMP(Eq)
+		HANDLE_CMP(Ne)
+		HANDLE_CMP(Ult)
+		HANDLE_CMP(Ule)
+		HANDLE_CMP(Ugt)
+		HANDLE_CMP(Uge)
+		HANDLE_CMP(Slt)
+		HANDLE_CMP(Sle)
+		HANDLE_CMP(Sgt)
+		HANDLE_CMP(Sge)
+#undef HANDLE_CMP
+	default:
+		ERROR("Malformed serialized annotation!\n");
+	}
+}
+
+void writeAnnot(ByteWriter &out, const std::optional<Annotation> &annot)
+{
+	out.writeBool(annot.has_value());
+	if (!annot)
+		return;
+	out.writeEnum(annot->type);
+	writeExpr(out, *annot->expr);
+}
+
+auto readAnnot(ByteReader &in) -> std::optional<Annotation>
+{
+	if (!in.readBool())
+		return std::nullopt;
+	auto type = in.readEnum<AssumeType>();
+	return Annotation(type, Annotation::ExprVP(readExpr(in).release()));
+}
+
+void writeNameInfo(ByteWriter &out, const NameInfo *info)
+{
+	out.writeBool(info != nullptr);
+	if (!info)
+		return;
+	out.writeU64(info->size());
+	for (const auto &[offset, name] : *info) {
+		out.writeU64(offset);
+		out.writeString(name);
+	}
+}
+
+/*
+ * Naming information normally lives in the module's info and is shared
+ * between labels. Deserialized objects are interned instead, so that they
+ * outlive all graphs that point to them, without being duplicated.
+ */
+auto readNameInfo(ByteReader &in) -> const NameInfo *
+{
+	if (!in.readBool())
+		return nullptr;
+
+	NameInfo info;
+	std::string key;
+	for (auto n = in.readU64(); n > 0; n--) {
+		auto offset = static_cast<unsigned>(in.readU64());
+		auto name = in.readString();
+		key += std::to_string(offset) + ":" + name + '\0';
+		info.addOffsetInfo(offset, std::move(name));
+	}
+
+	static std::mutex internMtx;
+	static std::map<std::string, std::unique_ptr<NameInfo>> interned;
+
+	std::lock_guard lock(internMtx);
+	auto &slot = interned[key];
+	if (!slot)
+		slot = std::make_unique<NameInfo>(std::move(info));
+	return &*slot;
+}
+
+void writeMemAccess(ByteWriter &out, const MemAccessLabel &mLab)
+{
+	out.writeU64(mLab.getAddr().get());
+	out.writeU64(mLab.getSize().get());
+	out.writeEnum(mLab.getType());
+	out.writeBool(mLab.wasAddedMax());
+	writeOptPos(out, mLab.getAlloc());
+}
+
+/** Writes all information that is specific to the kind of LAB */
+void writeLabelPayload(ByteWriter &out, const EventLabel &lab)
+{
+	if (const auto *tsLab = llvm::dyn_cast<ThreadStartLabel>(&lab)) {
+		tsLab->getCreateId().serialize(out);
+		writeThreadInfo(out, tsLab->getThreadInfo());
+		out.writeS64(tsLab->getSymmPredTid());
+		out.writeS64(tsLab->getSymmSuccTid());
+		writeOptPos(out, tsLab->getCreate());
+		return;
+	}
+	if (const auto *bLab = llvm::dyn_cast<JoinBlockLabel>(&lab)) {
+		out.writeU64(bLab->getChildId());
+		return;
+	}
+	if (const auto *bLab = llvm::dyn_cast<ReadOptBlockLabel>(&lab)) {
+		out.writeU64(bLab->getAddr().get());
+		return;
+	}
+	if (const auto *eLab = llvm::dyn_cast<ThreadFinishLabel>(&lab)) {
+		out.writeU64(eLab->getRetVal().get());
+		writeOptPos(out, eLab->getParentJoin());
+		return;
+	}
+	if (const auto *rLab = llvm::dyn_cast<ReadLabel>(&lab)) {
+		writeMemAccess(out, *rLab);
+		writeOptPos(out, rLab->getRf());
+		writeAnnot(out, rLab->getAnnot());
+		if (const auto *fLab = llvm::dyn_cast<FaiReadLabel>(rLab)) {
+			out.writeEnum(fLab->getOp());
+			out.writeU64(fLab->getOpVal().get());
+			out.writeEnum(fLab->getAttr());
+		}
+		if (const auto *cLab = llvm::dyn_cast<CasReadLabel>(rLab)) {
+			out.writeU64(cLab->getExpected().get());
+			out.writeU64(cLab->getSwapVal().get());
+			out.writeEnum(cLab->getAttr());
+		}
+		return;
+	}
+	if (const auto *wLab = llvm::dyn_cast<WriteLabel>(&lab)) {
+		writeMemAccess(out, *wLab);
+		out.writeU64(wLab->getVal().get());
+		out.writeEnum(wLab->getAttr());
+		writePosList(out, wLab->readers());
+		return;
+	}
+	if (const auto *aLab = llvm::dyn_cast<MallocLabel>(&lab)) {
+		out.writeU64(aLab->getAllocAddr().get());
+		out.writeU64(aLab->getAllocSize());
+		out.writeU64(aLab->getAlignment());
+		out.writeEnum(aLab->getStorageDuration());
+		out.writeEnum(aLab->getStorageType());
+		out.writeEnum(aLab->getAddressSpace());
+		out.writeString(aLab->getName());
+		writeNameInfo(out, aLab->getNameInfo());
+		writeOptPos(out, aLab->getFree());
+		writePosList(out, aLab->accesses());
+		return;
+	}
+	if (const auto *dLab = llvm::dyn_cast<FreeLabel>(&lab)) {
+		out.writeU64(dLab->getFreedAddr().get());
+		out.writeU64(dLab->getFreedSize());
+		writeOptPos(out, dLab->getAlloc());
+		return;
+	}
+	if (const auto *cLab = llvm::dyn_cast<ThreadCreateLabel>(&lab)) {
+		writeThreadInfo(out, cLab->getChildInfo());
+		return;
+	}
+	if (const auto *jLab = llvm::dyn_cast<ThreadJoinLabel>(&lab)) {
+		out.writeU64(jLab->getChildId());
+		return;
+	}
+	if (const auto *hpLab = llvm::dyn_cast<HpProtectLabel>(&lab)) {
+		out.writeU64(hpLab->getHpAddr().get());
+		out.writeU64(hpLab->getProtectedAddr().get());
+		return;
+	}
+	if (const auto *hLab = llvm::dyn_cast<HelpingCasLabel>(&lab)) {
+		out.writeU64(hLab->getAddr().get());
+		out.writeU64(hLab->getSize().get());
+		out.writeEnum(hLab->getType());
+		out.writeU64(hLab->getExpected().get());
+		out.writeU64(hLab->getSwapVal().get());
+		return;
+	}
+	if (const auto *oLab = llvm::dyn_cast<OptionalLabel>(&lab)) {
+		out.writeBool(oLab->isExpandable());
+		out.writeBool(oLab->isExpanded());
+		return;
+	}
+	if (const auto *bLab = llvm::dyn_cast<MethodBeginLabel>(&lab)) {
+		out.writeString(bLab->getName());
+		out.writeS64(bLab->getArgument());
+		writePosList(out, bLab->lin_preds());
+		return;
+	}
+	if (const auto *eLab = llvm::dyn_cast<MethodEndLabel>(&lab)) {
+		out.writeString(eLab->getName());
+		out.writeS64(eLab->getResult());
+		writePosList(out, eLab->lin_succs());
+		return;
+	}
+	/* Remaining labels carry no extra information */
+}
+
+/** Reads back a label written by writeLabelPayload() and records its pointers in REFS */
+auto readLabelPayload(ByteReader &in, EventLabel::EventLabelKind kind, Event pos, MemOrdering ord,
+		      LabelRefs &refs) -> std::unique_ptr<EventLabel>
+{
+	using Kind = EventLabel::EventLabelKind;
+
+	if (kind == Kind::ThreadStart || kind == Kind::Init) {
+		auto createId = Event::deserialize(in);
+		auto info = readThreadInfo(in);
+		auto symmPred = static_cast<int>(in.readS64());
+		auto symmSucc = static_cast<int>(in.readS64());
+		refs.create = readOptPos(in);
+
+		std::unique_ptr<ThreadStartLabel> lab;
+		if (kind == Kind::Init)
+			lab = InitLabel::create();
+		else
+			lab = ThreadStartLabel::create(pos, ord, createId, nullptr, info, symmPred);
+		lab->setSymmSuccTid(symmSucc);
+		return lab;
+	}
+
+	switch (kind) {
+#define HANDLE_PURE_BLOCK(_kind)                                                                   \
+	case Kind::_kind:                                                                          \
+		return _kind##Label::create(pos);
+		HANDLE_PURE_BLOCK(SpinloopBlock)
+		HANDLE_PURE_BLOCK(FaiZNEBlock)
+		HANDLE_PURE_BLOCK(LockZNEBlock)
+		HANDLE_PURE_BLOCK(HelpedCASBlock)
+		HANDLE_PURE_BLOCK(ConfirmationBlock)
+		HANDLE_PURE_BLOCK(LockNotAcqBlock)
+		HANDLE_PURE_BLOCK(LockNotRelBlock)
+		HANDLE_PURE_BLOCK(BarrierBlock)
+		HANDLE_PURE_BLOCK(ErrorBlock)
+		HANDLE_PURE_BLOCK(UserBlock)
+		HANDLE_PURE_BLOCK(ThreadKill)
+#undef HANDLE_PURE_BLOCK
+	case Kind::JoinBlock:
+		return JoinBlockLabel::create(pos, static_cast<unsigned>(in.readU64()));
+	case Kind::ReadOptBlock:
+		return ReadOptBlockLabel::create(pos, SAddr(in.readU64()));
+	case Kind::ThreadFinish: {
+		auto lab = ThreadFinishLabel::create(pos, ord, SVal(in.readU64()));
+		refs.parentJoin = readOptPos(in);
+		return lab;
+	}
+#define HANDLE_DUMMY(_kind)                                                                        \
+	case Kind::_kind:                                                                          \
+		return _kind##Label::create(pos);
+		HANDLE_DUMMY(LoopBegin)
+		HANDLE_DUMMY(SpinStart)
+		HANDLE_DUMMY(FaiZNESpinEnd)
+		HANDLE_DUMMY(LockZNESpinEnd)
+		HANDLE_DUMMY(Empty)
+#undef HANDLE_DUMMY
+	default:
+		break;
+	}
+
+	if (EventLabel::FIRST_MemAccess <= kind && kind <= EventLabel::LAST_MemAccess) {
+		auto addr = SAddr(in.readU64());
+		auto size = ASize(static_cast<std::uint32_t>(in.readU64()));
+		auto type = in.readEnum<AType>();
+		auto maximal = in.readBool();
+		refs.alloc = readOptPos(in);
+
+		std::unique_ptr<MemAccessLabel> lab;
+		if (EventLabel::FIRST_Read <= kind && kind <= EventLabel::LAST_Read) {
+			refs.rf = readOptPos(in);
+			auto annot = readAnnot(in);
+
+			std::unique_ptr<ReadLabel> rLab;
+			switch (kind) {
+#define HANDLE_READ(_kind)                                                                         \
+	case Kind::_kind:                                                                          \
+		rLab = _kind##Label::create(pos, ord, addr, size, type, nullptr, std::move(annot));        \
+		break;
+				HANDLE_READ(Read)
+				HANDLE_READ(BWaitRead)
+				HANDLE_READ(SpeculativeRead)
+				HANDLE_READ(ConfirmingRead)
+				HANDLE_READ(CondVarWaitRead)
+#undef HANDLE_READ
+			case Kind::FaiRead:
+			case Kind::NoRetFaiRead:
+			case Kind::BIncFaiRead: {
+				auto op = in.readEnum<RMWBinOp>();
+				auto val = SVal(in.readU64());
+				auto wattr = in.readEnum<WriteAttr>();
+				if (kind == Kind::FaiRead)
+					rLab = FaiReadLabel::create(pos, ord, addr, size, type, op, val,
+								    wattr, nullptr, std::move(annot));
+				else if (kind == Kind::NoRetFaiRead)
+					rLab = NoRetFaiReadLabel::create(pos, ord, addr, size, type, op,
+									 val, wattr, nullptr,
+									 std::move(annot));
+				else
+					rLab = BIncFaiReadLabel::create(pos, ord, addr, size, type, op,
+									val, wattr, nullptr,
+									std::move(annot));
+				break;
+			}
+			default: {
+				BUG_ON(!(EventLabel::FIRST_CasRead <= kind &&
+					 kind <= EventLabel::LAST_CasRead));
+				auto exp = SVal(in.readU64());
+				auto swap = SVal(in.readU64());
+				auto wattr = in.readEnum<WriteAttr>();
+				switch (kind) {
+#define HANDLE_CAS_READ(_kind)                                                                     \
+	case Kind::_kind:                                                                          \
+		rLab = _kind##Label::create(pos, ord, addr, size, type, exp, swap, wattr, nullptr,         \
+					    std::move(annot));                                     \
+		break;
+					HANDLE_CAS_READ(CasRead)
+					HANDLE_CAS_READ(LockCasRead)
+					HANDLE_CAS_READ(TrylockCasRead)
+					HANDLE_CAS_READ(HelpedCasRead)
+					HANDLE_CAS_READ(ConfirmingCasRead)
+#undef HANDLE_CAS_READ
+				case Kind::AbstractLockCasRead:
+					rLab = AbstractLockCasReadLabel::create(pos, addr, size,
+										std::move(annot));
+					break;
+				default:
+					ERROR("Malformed serialized graph (unknown label kind)!\n");
+				}
+				break;
+			}
+			}
+			lab = std::move(rLab);
+		} else {
+			auto val = SVal(in.readU64());
+			auto wattr = in.readEnum<WriteAttr>();
+			refs.related = readPosList(in);
+
+			std::unique_ptr<WriteLabel> wLab;
+			switch (kind) {
+#define HANDLE_WRITE(_kind)                                                                        \
+	case Kind::_kind:                                                                          \
+		wLab = _kind##Label::create(pos, ord, addr, size, type, val, wattr);                       \
+		break;
+				HANDLE_WRITE(Write)
+				HANDLE_WRITE(CondVarInitWrite)
+				HANDLE_WRITE(CondVarSignalWrite)
+				HANDLE_WRITE(CondVarBcastWrite)
+				HANDLE_WRITE(CondVarDestroyWrite)
+				HANDLE_WRITE(UnlockWrite)
+				HANDLE_WRITE(AbstractUnlockWrite)
+				HANDLE_WRITE(CasWrite)
+				HANDLE_WRITE(LockCasWrite)
+				HANDLE_WRITE(AbstractLockCasWrite)
+				HANDLE_WRITE(TrylockCasWrite)
+				HANDLE_WRITE(HelpedCasWrite)
+				HANDLE_WRITE(ConfirmingCasWrite)
+				HANDLE_WRITE(FaiWrite)
+				HANDLE_WRITE(NoRetFaiWrite)
+				HANDLE_WRITE(BIncFaiWrite)
+#undef HANDLE_WRITE
+			default:
+				ERROR("Malformed serialized graph (unknown label kind)!\n");
+			}
+			/* Some constructors drop the attributes */
+			wLab->setAttr(wattr);
+			lab = std::move(wLab);
+		}
+		lab->setAddedMax(maximal);
+		return lab;
+	}
+
+	switch (kind) {
+	case Kind::Fence:
+		return FenceLabel::create(pos, ord);
+	case Kind::Malloc: {
+		auto addr = SAddr(in.readU64());
+		auto size = static_cast<unsigned>(in.readU64());
+		auto alignment = static_cast<unsigned>(in.readU64());
+		auto sdur = in.readEnum<StorageDuration>();
+		auto stype = in.readEnum<StorageType>();
+		auto spc = in.readEnum<AddressSpace>();
+		auto name = in.readString();
+		const auto *info = readNameInfo(in);
+		refs.free = readOptPos(in);
+		refs.related = readPosList(in);
+		return MallocLabel::create(pos, ord, addr, size, alignment, sdur, stype, spc, info,
+					   name);
+	}
+	case Kind::Free:
+	case Kind::HpRetire: {
+		auto addr = SAddr(in.readU64());
+		auto size = static_cast<unsigned>(in.readU64());
+		refs.alloc = readOptPos(in);
+		if (kind == Kind::Free)
+			return FreeLabel::create(pos, ord, addr, size);
+		return HpRetireLabel::create(pos, ord, addr, size);
+	}
+	case Kind::ThreadCreate:
+		return ThreadCreateLabel::create(pos, ord, readThreadInfo(in));
+	case Kind::ThreadJoin:
+		return ThreadJoinLabel::create(pos, ord, static_cast<unsigned>(in.readU64()));
+	case Kind::HpProtect: {
+		auto hpAddr = SAddr(in.readU64());
+		auto protAddr = SAddr(in.readU64());
+		return HpProtectLabel::create(pos, ord, hpAddr, protAddr);
+	}
+	case Kind::HelpingCas: {
+		auto addr = SAddr(in.readU64());
+		auto size = ASize(static_cast<std::uint32_t>(in.readU64()));
+		auto type = in.readEnum<AType>();
+		auto exp = SVal(in.readU64());
+		auto swap = SVal(in.readU64());
+		return HelpingCasLabel::create(pos, ord, addr, size, type, exp, swap);
+	}
+	case Kind::Optional: {
+		auto lab = OptionalLabel::create(pos);
+		lab->setExpandable(in.readBool());
+		lab->setExpanded(in.readBool());
+		return lab;
+	}
+	case Kind::MethodBegin: {
+		auto name = in.readString();
+		auto arg = static_cast<int32_t>(in.readS64());
+		refs.related = readPosList(in);
+		return MethodBeginLabel::create(pos, std::move(name), arg);
+	}
+	case Kind::MethodEnd: {
+		auto name = in.readString();
+		auto res = static_cast<int32_t>(in.readS64());
+		refs.related = readPosList(in);
+		return MethodEndLabel::create(pos, std::move(name), res);
+	}
+	default:
+		ERROR("Malformed serialized graph (unknown label kind)!\n");
+	}
+}
+
+} // namespace
+
+void ExecutionGraph::serialize(ByteWriter &out) const
+{
+	out.writeU64(GRAPH_FORMAT_VERSION);
+	out.writeEnum(dynamic_cast<const DepExecutionGraph *>(this) ? GraphType::Dep
+								     : GraphType::Plain);
+	out.writeS64(recoveryTID);
+	out.writeU64(timestamp.get());
+
+	out.writeU64(getNumThreads());
+	for (auto i : thr_ids())
+		out.writeU64(getThreadSize(i));
+
+	/* Labels, in insertion order */
+	out.writeU64(insertionOrder.size());
+	for (const auto &lab : labels()) {
+		out.writeEnum(lab.getKind());
+		lab.getPos().serialize(out);
+		out.writeEnum(lab.getOrdering());
+		out.writeU64(lab.getStamp().get());
+		out.writeBool(lab.isRevisitable());
+		writeDeps(out, lab.getDeps());
+
+		out.writeU64(lab.calculatedRels.size());
+		for (const auto &rel : lab.calculatedRels)
+			writeEventSet(out, rel);
+		out.writeU64(getNumViews(&lab));
+		for (auto i = 0U; i < getNumViews(&lab); i++)
+			getView(&lab, i).serialize(out);
+		out.writeBool(lab.hasPrefixView());
+		if (lab.hasPrefixView())
+			lab.getPrefixView().serialize(out);
+
+		writeLabelPayload(out, lab);
+	}
+
+	/* Per-location information */
+	auto numLocs = std::ranges::distance(locs());
+	out.writeU64(numLocs);
+	for (const auto &loc : locs()) {
+		out.writeU64(loc.addr.get());
+		writePosList(out, loc.stores);
+	}
+	out.writeU64(numLocs);
+	for (const auto &loc : locs()) {
+		out.writeU64(loc.addr.get());
+		writePosList(out, loc.initRfs);
+	}
+	out.writeU64(numLocs);
+	for (const auto &loc : locs()) {
+		out.writeU64(loc.addr.get());
+		writePosList(out, std::array{&loc.accesses.reads, &loc.accesses.writes,
+					     &loc.accesses.frees} |
+				      std::views::transform([](auto *list) -> auto & { return *list; }) |
+				      std::views::join);
+	}
+}
+
+auto ExecutionGraph::deserialize(ByteReader &in, InitValGetter f) -> std::unique_ptr<ExecutionGraph>
+{
+	ERROR_ON(in.readU64() != GRAPH_FORMAT_VERSION,
+		 "Unsupported serialized graph format version!\n");
+
+	auto type = in.readEnum<GraphType>();
+	ERROR_ON(type != GraphType::Plain && type != GraphType::Dep,
+		 "Malformed serialized graph (unknown graph type)!\n");
+	std::unique_ptr<ExecutionGraph> g;
+	if (type == GraphType::Dep)
+		g = std::make_unique<DepExecutionGraph>(std::move(f));
+	else
+		g = std::make_unique<ExecutionGraph>(std::move(f));
+
+	/* Start from scratch: the initializer is part of the input */
+	g->insertionOrder.clear();
+	g->poLists.clear();
+	g->events.clear();
+	g->locIds_.clear();
+	g->locations_.clear();
+	g->viewStore_.clear();
+
+	g->recoveryTID = static_cast<int>(in.readS64());
+	g->resetStamp(static_cast<uint32_t>(in.readU64()));
+
+	auto numThreads = in.readU64();
+	g->events.resize(numThreads);
+	g->poLists.resize(numThreads);
+	for (auto &thread : g->events)
+		thread.resize(in.readU64());
+
+	std::vector<LabelRefs> refs(in.readU64());
+	for (auto &r : refs) {
+		auto kind = in.readEnum<EventLabel::EventLabelKind>();
+		auto pos = Event::deserialize(in);
+		auto ord = in.readEnum<MemOrdering>();
+		auto stamp = static_cast<uint32_t>(in.readU64());
+		auto revisitable = in.readBool();
+		auto deps = readDeps(in);
+
+		std::vector<VSet<Event>> rels(in.readU64());
+		for (auto &rel : rels)
+			rel = readEventSet(in);
+		std::vector<View> views;
+		for (auto n = in.readU64(); n > 0; n--) {
+			auto vc = VectorClock::deserialize(in);
+			auto *v = llvm::dyn_cast<View>(&*vc);
+			ERROR_ON(!v, "Malformed serialized graph (unexpected view kind)!\n");
+			views.push_back(std::move(*v));
+		}
+		auto prefix = in.readBool() ? VectorClock::deserialize(in) : nullptr;
+
+		auto lab = readLabelPayload(in, kind, pos, ord, r);
+		ERROR_ON(!g->containsPos(pos) || g->events[pos.thread][pos.index],
+			 "Malformed serialized graph (invalid label position)!\n");
+
+		lab->setOrdering(ord);
+		lab->setStamp(stamp);
+		lab->setRevisitStatus(revisitable);
+		lab->setDeps(std::move(deps));
+		lab->setCalculated(std::move(rels));
+		lab->setPrefixView(std::move(prefix));
+		lab->setParent(&*g);
+		if (auto *mLab = llvm::dyn_cast<MemAccessLabel>(&*lab))
+			mLab->locId = g->getLocId(mLab->getAddr());
+		for (auto &v : views)
+			g->addView(&*lab, std::move(v));
+
+		r.lab = &*lab;
+		g->insertionOrder.push_back(*lab);
+		g->setEventLabel(pos, std::move(lab));
+	}
+	for (auto i = 0U; i < g->events.size(); i++) {
+		for (auto &lab : g->events[i]) {
+			ERROR_ON(!lab, "Malformed serialized graph (missing labels)!\n");
+			g->poLists[i].push_back(*lab);
+		}
+	}
+	ERROR_ON(g->events.empty() || g->events[0].empty() ||
+			 !llvm::isa<InitLabel>(g->getEventLabel(Event::getInit())),
+		 "Malformed serialized graph (missing initializer)!\n");
+
+	/* Fix pointers */
+	for (auto &r : refs) {
+		auto *lab = r.lab;
+		if (auto *tsLab = llvm::dyn_cast<ThreadStartLabel>(lab); tsLab && r.create)
+			tsLab->setCreate(getLabelAt<ThreadCreateLabel>(*g, *r.create));
+		if (auto *eLab = llvm::dyn_cast<ThreadFinishLabel>(lab); eLab && r.parentJoin)
+			eLab->setParentJoin(getLabelAt<ThreadJoinLabel>(*g, *r.parentJoin));
+		if (auto *mLab = llvm::dyn_cast<MemAccessLabel>(lab); mLab && r.alloc)
+			mLab->setAlloc(getLabelAt<MallocLabel>(*g, *r.alloc));
+		if (auto *rLab = llvm::dyn_cast<ReadLabel>(lab); rLab && r.rf)
+			rLab->setRfNoCascade(getLabelAt(*g, *r.rf));
+		if (auto *wLab = llvm::dyn_cast<WriteLabel>(lab)) {
+			for (auto &e : r.related)
+				wLab->addReader(getLabelAt<ReadLabel>(*g, e));
+		}
+		if (auto *aLab = llvm::dyn_cast<MallocLabel>(lab)) {
+			if (r.free)
+				aLab->setFree(getLabelAt<FreeLabel>(*g, *r.free));
+			for (auto &e : r.related)
+				aLab->addAccess(getLabelAt<MemAccessLabel>(*g, e));
+		}
+		if (auto *dLab = llvm::dyn_cast<FreeLabel>(lab); dLab && r.alloc)
+			dLab->setAlloc(getLabelAt<MallocLabel>(*g, *r.alloc));
+		if (auto *bLab = llvm::dyn_cast<MethodBeginLabel>(lab)) {
+			for (auto &e : r.related)
+				bLab->addPredNoCascade(getLabelAt<MethodEndLabel>(*g, e));
+		}
+		if (auto *eLab = llvm::dyn_cast<MethodEndLabel>(lab)) {
+			for (auto &e : r.related)
+				eLab->addSuccNoCascade(getLabelAt<MethodBeginLabel>(*g, e));
+		}
+	}
+
+	/* Finally, restore the per-location information */
+	for (auto n = in.readU64(); n > 0; n--) {
+		auto &loc = g->getLoc(SAddr(in.readU64()));
+		for (auto &e : readPosList(in))
+			loc.stores.push_back(*getLabelAt<WriteLabel>(*g, e));
+		g->repackCo(loc);
+	}
+	for (auto n = in.readU64(); n > 0; n--) {
+		auto &readers = g->getLoc(SAddr(in.readU64())).initRfs;
+		for (auto &e : readPosList(in))
+			readers.push_back(*getLabelAt<ReadLabel>(*g, e));
+	}
+	for (auto n = in.readU64(); n > 0; n--) {
+		auto &accesses = g->getLoc(SAddr(in.readU64())).accesses;
+		for (auto &e : readPosList(in))
+			accesses.add(getLabelAt(*g, e));
+	}
+	return g;
+}
+
+auto ExecutionGraph::save(const std::string &file) const -> bool
+{
+	ByteWriter out;
+	serialize(out);
+
+	std::error_code err;
+	llvm::raw_fd_ostream os(file, err, llvm::sys::fs::OF_None);
+	if (err)
+		return false;
+	os << GRAPH_FILE_MAGIC;
+	os.write(reinterpret_cast<const char *>(out.data().data()), out.size());
+	os.close();
+	return !os.has_error();
+}
+
+auto ExecutionGraph::load(const std::string &file, InitValGetter f)
+	-> std::unique_ptr<ExecutionGraph>
+{
+	auto bufOrErr = llvm::MemoryBuffer::getFile(file, /* IsText */ false,
+						    /* RequiresNullTerminator */ false);
+	if (!bufOrErr)
+		return nullptr;
+
+	auto contents = (*bufOrErr)->getBuffer();
+	ERROR_ON(contents.take_front(GRAPH_FILE_MAGIC.size()) != GRAPH_FILE_MAGIC,
+		 "Not a serialized execution graph: " << file << "\n");
+	contents = contents.drop_front(GRAPH_FILE_MAGIC.size());
+
+	ByteReader in(reinterpret_cast<const std::uint8_t *>(contents.data()), contents.size());
+	auto g = deserialize(in, std::move(f));
+	ERROR_ON(!in.atEnd(), "Malformed serialized graph (trailing data)!\n");
+	return g;
+}
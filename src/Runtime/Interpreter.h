@@ -287,6 +287,9 @@ public:
 	std::unique_ptr<InterpreterState> saveState();
 	void restoreState(std::unique_ptr<InterpreterState>);
 
+	/* Whether the program has been set up to run (i.e., ran at least once) */
+	bool hasRunMain() const { return !mainECStack.empty(); }
+
 	Thread &constructAddThreadFromInfo(const ThreadInfo &ti)
 	{
 		auto *calledFun =
@@ -0,0 +1,462 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#include "DistributedPool.hpp"
+#include "ExecutionGraph/DepExecutionGraph.hpp"
+#include "Support/Error.hpp"
+#include "Support/Serialization.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <poll.h>
+#include <sys/wait.h>
+
+static auto createEmptyExecution(const Config &conf) -> std::unique_ptr<GenMCDriver::Execution>
+{
+	auto dummyGetter = [](auto &addr) { return SVal(0); };
+	auto execGraph = conf.isDepTrackingModel ? std::make_unique<DepExecutionGraph>(dummyGetter)
+						 : std::make_unique<ExecutionGraph>(dummyGetter);
+	return std::make_unique<GenMCDriver::Execution>(std::move(execGraph), WorkList(),
+							ChoiceMap(), SAddrAllocator(),
+							Event::getInit());
+}
+
+/* Identifies the two ends of a channel as GenMC processes speaking the same
+ * protocol; bump the version whenever the messages (or their payloads) change */
+static constexpr const char *DISTRIBUTED_MAGIC = "genmc-distributed";
+static constexpr std::uint64_t DISTRIBUTED_PROTOCOL_VERSION = 4;
+
+/* How long a peer that just connected has to complete its greeting */
+static constexpr std::chrono::seconds HANDSHAKE_TIMEOUT{10};
+
+/* The Hello carries the shared TOKEN, so that only peers that know it are trusted */
+static auto createHelloPayload(const std::string &token) -> std::vector<std::uint8_t>
+{
+	ByteWriter out;
+	out.writeString(DISTRIBUTED_MAGIC);
+	out.writeU64(DISTRIBUTED_PROTOCOL_VERSION);
+	out.writeString(token);
+	return out.take();
+}
+
+/* Compares A and B in time that does not depend on where they differ */
+static auto constantTimeEqual(const std::vector<std::uint8_t> &a,
+			      const std::vector<std::uint8_t> &b) -> bool
+{
+	if (a.size() != b.size())
+		return false;
+	std::uint8_t diff = 0;
+	for (auto i = 0U; i < a.size(); i++)
+		diff |= a[i] ^ b[i];
+	return diff == 0;
+}
+
+/* Returns whether the next message on CH is a matching Hello */
+static auto receiveHello(MessageChannel &ch, const std::string &token) -> bool
+{
+	/* The peer is not trusted yet: accept nothing larger than the Hello we
+	 * expect, and nothing that trickles in past the deadline */
+	auto expected = createHelloPayload(token);
+	auto msg = ch.receive(static_cast<std::uint8_t>(DistributedMsg::Hello), expected.size(),
+			      std::chrono::steady_clock::now() + HANDSHAKE_TIMEOUT);
+	return msg && constantTimeEqual(msg->payload, expected);
+}
+
+static auto serializeExecution(const GenMCDriver::Execution &exec) -> std::vector<std::uint8_t>
+{
+	ByteWriter out;
+	exec.serialize(out);
+	return out.take();
+}
+
+/*******************************************************************************
+ **                         DistributedCoordinator
+ ******************************************************************************/
+
+auto DistributedCoordinator::addWorker(std::unique_ptr<MessageChannel> ch, pid_t pid /* = -1 */)
+	-> bool
+{
+	/* Workers greet first, so that anything else connecting to
+	 * the coordinator is turned away before it is sent any work */
+	const auto &token = conf_->distributedToken;
+	if (!receiveHello(*ch, token) ||
+	    !ch->send(static_cast<std::uint8_t>(DistributedMsg::Hello), createHelloPayload(token)))
+		return false;
+	workers_.push_back(Worker{std::move(ch), pid});
+	return true;
+}
+
+auto DistributedCoordinator::getNumIdle() const -> unsigned int
+{
+	return std::count_if(workers_.begin(), workers_.end(),
+			     [](auto &w) { return w.alive && !w.busy; });
+}
+
+auto DistributedCoordinator::getNumBusy() const -> unsigned int
+{
+	return std::count_if(workers_.begin(), workers_.end(),
+			     [](auto &w) { return w.alive && w.busy; });
+}
+
+void DistributedCoordinator::broadcast(DistributedMsg type,
+				       const std::vector<std::uint8_t> &payload /* = {} */)
+{
+	for (auto &w : workers_)
+		if (w.alive)
+			w.ch->send(static_cast<std::uint8_t>(type), payload);
+}
+
+void DistributedCoordinator::dispatchTasks()
+{
+	for (auto &w : workers_) {
+		if (queue_.empty())
+			return;
+		if (!w.alive || w.busy)
+			continue;
+		if (!w.ch->send(static_cast<std::uint8_t>(DistributedMsg::Task), queue_.front())) {
+			w.alive = false;
+			continue;
+		}
+		w.task = std::move(queue_.front());
+		queue_.pop_front();
+		w.busy = true;
+		w.requested = false;
+		w.submittedDuringTask = 0;
+	}
+}
+
+void DistributedCoordinator::requestWork()
+{
+	/* Workers only need to know about idle workers with nothing queued for them */
+	auto idle = getNumIdle();
+	auto hint = idle > queue_.size() ? idle - queue_.size() : 0;
+	if (hint != lastIdleHint_) {
+		ByteWriter out;
+		out.writeU64(hint);
+		broadcast(DistributedMsg::IdleHint, out.data());
+		lastIdleHint_ = hint;
+	}
+
+	/* Ask as many busy workers as there are idle ones to donate some work */
+	if (!queue_.empty())
+		return;
+	auto pending = std::count_if(workers_.begin(), workers_.end(),
+				     [](auto &w) { return w.alive && w.requested; });
+	for (auto &w : workers_) {
+		if (pending >= idle)
+			return;
+		if (!w.alive || !w.busy || w.requested)
+			continue;
+		w.ch->send(static_cast<std::uint8_t>(DistributedMsg::WorkRequest));
+		w.requested = true;
+		++pending;
+	}
+}
+
+void DistributedCoordinator::handleMessage(Worker &w, MessageChannel::Message msg)
+{
+	switch (static_cast<DistributedMsg>(msg.type)) {
+	case DistributedMsg::Donate:
+		++donated_;
+		w.requested = false;
+		[[fallthrough]];
+	case DistributedMsg::Submit:
+		++submitted_;
+		++w.submittedDuringTask;
+		if (!halted_)
+			queue_.push_back(std::move(msg.payload));
+		break;
+	case DistributedMsg::Done: {
+		ByteReader in(msg.payload);
+		addResult(w, VerificationResult::deserialize(in));
+		w.busy = false;
+		w.requested = false;
+		w.task.clear();
+		break;
+	}
+	case DistributedMsg::Halt:
+		if (!halted_) {
+			halted_ = true;
+			queue_.clear();
+			broadcast(DistributedMsg::Halt);
+		}
+		break;
+	default:
+		ERROR("Unexpected message from distributed worker!\n");
+	}
+}
+
+auto DistributedCoordinator::run() -> VerificationResult
+{
+	BUG_ON(workers_.empty());
+
+	queue_.push_back(serializeExecution(*createEmptyExecution(*conf_)));
+	++submitted_;
+
+	std::vector<pollfd> fds;
+	while (true) {
+		if (!halted_)
+			dispatchTasks();
+		if (getNumBusy() == 0) {
+			ERROR_ON(!halted_ && !queue_.empty(), "All distributed workers were lost!\n");
+			break;
+		}
+		requestWork();
+
+		fds.clear();
+		for (auto &w : workers_)
+			fds.push_back({w.alive ? w.ch->getFd() : -1, POLLIN, 0});
+		if (poll(fds.data(), fds.size(), -1) < 0) {
+			ERROR_ON(errno != EINTR, "Polling distributed workers failed!\n");
+			continue;
+		}
+
+		for (auto i = 0U; i < workers_.size(); i++) {
+			auto &w = workers_[i];
+			if (!w.alive || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+				continue;
+			auto msg = w.ch->receive();
+			if (!msg) {
+				handleLostWorker(w);
+				continue;
+			}
+			handleMessage(w, std::move(*msg));
+		}
+	}
+	return collectResults();
+}
+
+void DistributedCoordinator::addResult(Worker &w, VerificationResult delta)
+{
+	/* Peaks are sampled per task: a worker's peak is the largest of its
+	 * tasks', while the peaks of different workers add up (see collectResults()) */
+	w.peaks.takePeaks(delta);
+	result_ += std::move(delta);
+}
+
+void DistributedCoordinator::handleLostWorker(Worker &w)
+{
+	w.alive = false;
+	if (!w.busy || halted_)
+		return;
+
+	/* Everything the worker submitted has been received, and its results are
+	 * only reported once its task is done. If it submitted nothing, its task
+	 * can simply be explored again; otherwise, re-exploring it would
+	 * explore the submitted executions twice */
+	ERROR_ON(w.submittedDuringTask != 0,
+		 "Lost connection to a distributed worker in the middle of a task; "
+		 "the exploration would be incomplete!\n");
+	w.busy = false;
+	queue_.push_front(std::move(w.task));
+}
+
+auto DistributedCoordinator::collectResults() -> VerificationResult
+{
+	broadcast(DistributedMsg::Shutdown);
+
+	/* Results have been streamed in with each task; only times are left */
+	auto res = std::move(result_);
+	for (auto &w : workers_) {
+		while (w.alive) {
+			auto msg = w.ch->receive();
+			if (!msg) {
+				w.alive = false;
+				break;
+			}
+			if (static_cast<DistributedMsg>(msg->type) != DistributedMsg::Result)
+				continue;
+
+			ByteReader in(msg->payload);
+			auto wres = VerificationResult::deserialize(in);
+			res.workerTimes.insert(res.workerTimes.end(), wres.workerTimes.begin(),
+					       wres.workerTimes.end());
+			w.alive = false;
+		}
+		res += std::move(w.peaks);
+	}
+	res.tasksSubmitted = submitted_;
+	res.tasksDonated = donated_;
+	return res;
+}
+
+DistributedCoordinator::~DistributedCoordinator()
+{
+	for (auto &w : workers_) {
+		w.ch.reset();
+		if (w.pid > 0)
+			waitpid(w.pid, nullptr, 0);
+	}
+}
+
+/*******************************************************************************
+ **                           DistributedWorker
+ ******************************************************************************/
+
+DistributedWorker::DistributedWorker(std::unique_ptr<MessageChannel> ch, const std::string &token)
+	: ch_(std::move(ch))
+{
+	ERROR_ON(!ch_->send(static_cast<std::uint8_t>(DistributedMsg::Hello),
+			    createHelloPayload(token)) ||
+			 !receiveHello(*ch_, token),
+		 "Distributed coordinator rejected the connection (version or token mismatch?)!\n");
+	receiver_ = std::thread([this] { receiveMessages(); });
+}
+
+void DistributedWorker::receiveMessages()
+{
+	while (auto msg = ch_->receive()) {
+		switch (static_cast<DistributedMsg>(msg->type)) {
+		case DistributedMsg::Task: {
+			std::lock_guard<std::mutex> lock(mtx_);
+			queuedBytes_ += msg->payload.size();
+			tasks_.push_back(std::move(msg->payload));
+			cv_.notify_one();
+			break;
+		}
+		case DistributedMsg::WorkRequest:
+			++workRequests_;
+			break;
+		case DistributedMsg::IdleHint: {
+			ByteReader in(msg->payload);
+			idleHint_.store(in.readU64());
+			break;
+		}
+		case DistributedMsg::Halt:
+			shouldHalt_.store(true);
+			break;
+		case DistributedMsg::Shutdown: {
+			std::lock_guard<std::mutex> lock(mtx_);
+			shutdown_ = true;
+			cv_.notify_one();
+			return;
+		}
+		default:
+			ERROR("Unexpected message from distributed coordinator!\n");
+		}
+	}
+
+	/* The coordinator is gone; there is nobody to report to */
+	shouldHalt_.store(true);
+	std::lock_guard<std::mutex> lock(mtx_);
+	shutdown_ = true;
+	cv_.notify_one();
+}
+
+auto DistributedWorker::popTask() -> std::vector<std::uint8_t>
+{
+	std::unique_lock<std::mutex> lock(mtx_);
+	cv_.wait(lock, [this] { return shutdown_ || !tasks_.empty(); });
+	if (tasks_.empty())
+		return {};
+	auto t = std::move(tasks_.front());
+	tasks_.pop_front();
+	queuedBytes_ -= t.size();
+	return t;
+}
+
+void DistributedWorker::run(GenMCDriver *driver, llvm::Interpreter *EE, TFunT threadFun)
+{
+	auto dummyGetter = [](auto &addr) { return SVal(0); };
+	std::chrono::steady_clock::duration busy{};
+	std::chrono::steady_clock::duration idle{};
+
+	while (true) {
+		auto idleStart = std::chrono::steady_clock::now();
+		auto task = popTask();
+		auto start = std::chrono::steady_clock::now();
+		idle += start - idleStart;
+		if (task.empty())
+			break;
+
+		/* Requests are answered by whoever was busy when they were made */
+		workRequests_.store(0);
+
+		ByteReader in(task);
+		driver->initFromState(GenMCDriver::Execution::deserialize(in, dummyGetter));
+		if (!shouldHalt() &&
+		    (driver->getExec().getWorkqueue().empty() || !driver->done()))
+			threadFun(driver, EE);
+		busy += std::chrono::steady_clock::now() - start;
+
+		/* Report what this task found, so that nothing is lost if we exit */
+		ByteWriter out;
+		driver->takeResult().serialize(out);
+		send(DistributedMsg::Done, out.data());
+		GENMC_DEBUG(if (++explored_ == exitAfter_) return;);
+	}
+
+	VerificationResult res;
+	res.workerTimes.emplace_back(busy, idle);
+	ByteWriter out;
+	res.serialize(out);
+	ch_->send(static_cast<std::uint8_t>(DistributedMsg::Result), out.data());
+}
+
+void DistributedWorker::send(DistributedMsg type, const std::vector<std::uint8_t> &payload)
+{
+	/* If the coordinator cannot know about the work we explored (or
+	 * submitted), make it see us as lost rather than waiting for us */
+	if (!ch_->send(static_cast<std::uint8_t>(type), payload)) {
+		shouldHalt_.store(true);
+		ch_->shutdown();
+	}
+}
+
+void DistributedWorker::sendExecution(DistributedMsg type, const TaskT &task)
+{
+	send(type, serializeExecution(*task));
+#ifdef ENABLE_GENMC_DEBUG
+	if (type == DistributedMsg::Submit && ++submitted_ == crashAfter_) {
+		llvm::outs().flush();
+		llvm::errs().flush();
+		std::_Exit(EGENMC);
+	}
+#endif
+}
+
+void DistributedWorker::submit(TaskT task)
+{
+	/* Every submission feeds one idle worker */
+	auto hint = idleHint_.load();
+	while (hint > 0 && !idleHint_.compare_exchange_weak(hint, hint - 1))
+		;
+	sendExecution(DistributedMsg::Submit, task);
+}
+
+void DistributedWorker::donate(TaskT task) { sendExecution(DistributedMsg::Donate, task); }
+
+auto DistributedWorker::tryClaimWorkRequest() -> bool
+{
+	auto reqs = workRequests_.load(std::memory_order_relaxed);
+	while (reqs > 0) {
+		if (workRequests_.compare_exchange_weak(reqs, reqs - 1))
+			return true;
+	}
+	return false;
+}
+
+void DistributedWorker::halt()
+{
+	if (shouldHalt_.exchange(true))
+		return;
+	ch_->send(static_cast<std::uint8_t>(DistributedMsg::Halt));
+}
+
+DistributedWorker::~DistributedWorker()
+{
+	ch_->shutdown();
+	if (receiver_.joinable())
+		receiver_.join();
+}
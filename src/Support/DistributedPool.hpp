@@ -0,0 +1,226 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#ifndef GENMC_DISTRIBUTED_POOL_HPP
+#define GENMC_DISTRIBUTED_POOL_HPP
+
+#include "Config/Config.hpp"
+#include "Support/MessageChannel.hpp"
+#include "Support/WorkPool.hpp"
+#include "Verification/VerificationResult.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sys/types.h>
+#include <thread>
+#include <vector>
+
+namespace llvm {
+class Interpreter;
+}
+
+/**
+ * Distributed exploration: a coordinator process hands out (serialized)
+ * executions to worker processes, each running its own driver.
+ * Workers submit work back to the coordinator in the same way drivers
+ * submit work to a ThreadPool.
+ */
+
+/** The messages exchanged between the coordinator and the workers */
+enum class DistributedMsg : std::uint8_t {
+	Task,	     /**< C->W: an execution to explore */
+	Submit,	     /**< W->C: an execution submitted by the worker */
+	Donate,	     /**< W->C: an execution donated after a WorkRequest */
+	WorkRequest, /**< C->W: an idle worker is asking for work */
+	IdleHint,    /**< C->W: the number of idle workers without a task */
+	Done,	     /**< W->C: the worker finished its task; carries the task's result */
+	Halt,	     /**< both: stop exploring (e.g., an error was found) */
+	Result,	     /**< W->C: the worker's busy/idle times */
+	Shutdown,    /**< C->W: no more tasks; report the times */
+	Hello,	     /**< both: the first message on a channel (see handshake) */
+};
+
+/*******************************************************************************
+ **                         DistributedCoordinator Class
+ ******************************************************************************/
+
+/** Distributes tasks to workers and collects their results */
+class DistributedCoordinator {
+
+public:
+	explicit DistributedCoordinator(std::shared_ptr<const Config> conf) : conf_(std::move(conf))
+	{}
+
+	DistributedCoordinator(const DistributedCoordinator &) = delete;
+	auto operator=(const DistributedCoordinator &) -> DistributedCoordinator & = delete;
+
+	/** Registers a worker reachable through CH. If the worker is a child
+	 * process, PID is used to reap it once done. Returns false (dropping
+	 * the connection) if the peer does not greet us as a GenMC worker
+	 * speaking the same protocol version and knowing the shared token */
+	auto addWorker(std::unique_ptr<MessageChannel> ch, pid_t pid = -1) -> bool;
+
+	/** Runs the exploration until all tasks are completed (or some worker
+	 * halts the exploration), and returns the merged results */
+	auto run() -> VerificationResult;
+
+	~DistributedCoordinator();
+
+private:
+	struct Worker {
+		std::unique_ptr<MessageChannel> ch;
+		pid_t pid = -1;
+		bool alive = true;
+		bool busy = false;
+		bool requested = false; /**< Whether a WorkRequest is pending */
+		std::vector<std::uint8_t> task{}; /**< The task being explored (if busy) */
+		unsigned submittedDuringTask = 0;
+		VerificationResult peaks{}; /**< The peaks reported by the worker's tasks */
+	};
+
+	/** Hands queued tasks to idle workers */
+	void dispatchTasks();
+
+	/** Asks busy workers for work, and lets them know how many are idle */
+	void requestWork();
+
+	/** Processes a message received from worker W */
+	void handleMessage(Worker &w, MessageChannel::Message msg);
+
+	/** Adds the result of a task explored by W to the overall result */
+	void addResult(Worker &w, VerificationResult delta);
+
+	/** Handles the loss of the connection to W, re-queueing its task.
+	 * Exits with an error if the task cannot be explored again */
+	void handleLostWorker(Worker &w);
+
+	/** Stops all workers and collects their times */
+	auto collectResults() -> VerificationResult;
+
+	[[nodiscard]] auto getNumIdle() const -> unsigned int;
+	[[nodiscard]] auto getNumBusy() const -> unsigned int;
+
+	void broadcast(DistributedMsg type, const std::vector<std::uint8_t> &payload = {});
+
+	std::shared_ptr<const Config> conf_;
+	std::vector<Worker> workers_;
+
+	/** Serialized executions waiting for a worker */
+	std::deque<std::vector<std::uint8_t>> queue_;
+
+	/** The results of the completed tasks */
+	VerificationResult result_;
+
+	/** The idle hint last sent to the workers */
+	unsigned int lastIdleHint_ = 0;
+
+	bool halted_ = false;
+	unsigned submitted_ = 0;
+	unsigned donated_ = 0;
+};
+
+/*******************************************************************************
+ **                           DistributedWorker Class
+ ******************************************************************************/
+
+/** The WorkPool of a driver running in a worker process */
+class DistributedWorker : public WorkPool {
+
+public:
+	using TFunT = void (*)(GenMCDriver *, llvm::Interpreter *);
+
+	/** Greets the coordinator at the other end of CH, presenting TOKEN */
+	DistributedWorker(std::unique_ptr<MessageChannel> ch, const std::string &token);
+
+	/** Explores the tasks sent by the coordinator using DRIVER and EE,
+	 * reporting the result of each, until the coordinator shuts us down */
+	void run(GenMCDriver *driver, llvm::Interpreter *EE, TFunT threadFun);
+
+#ifdef ENABLE_GENMC_DEBUG
+	/** For testing: if EXITAFTER is non-zero, makes run() exit (without
+	 * saying goodbye) after exploring that many tasks, and if CRASHAFTER
+	 * is non-zero, crashes right after submitting that many executions */
+	void injectFaults(unsigned int exitAfter, unsigned int crashAfter)
+	{
+		exitAfter_ = exitAfter;
+		crashAfter_ = crashAfter;
+	}
+#endif
+
+	[[nodiscard]] auto shouldSubmit(unsigned int graphSize) const -> bool override
+	{
+		return !shouldHalt() && idleHint_.load() > 0;
+	}
+
+	void submit(TaskT task) override;
+
+	void donate(TaskT task) override;
+
+	auto tryClaimWorkRequest() -> bool override;
+
+	void unclaimWorkRequest() override { ++workRequests_; }
+
+	[[nodiscard]] auto shouldHalt() const -> bool override { return shouldHalt_.load(); }
+
+	void halt() override;
+
+	/** Only the tasks received from the coordinator are held here */
+	[[nodiscard]] auto getMemoryUsage() const -> std::size_t override
+	{
+		return queuedBytes_.load();
+	}
+
+	void limitMemoryUsage() override {}
+
+	[[nodiscard]] auto isDistributed() const -> bool override { return true; }
+
+	~DistributedWorker() override;
+
+private:
+	/** Receives messages from the coordinator (runs on a separate thread) */
+	void receiveMessages();
+
+	/** Blocks until a task arrives. Returns an empty payload on shutdown */
+	auto popTask() -> std::vector<std::uint8_t>;
+
+	/** Sends a message to the coordinator, dropping the connection if that fails */
+	void send(DistributedMsg type, const std::vector<std::uint8_t> &payload = {});
+
+	void sendExecution(DistributedMsg type, const TaskT &task);
+
+	std::unique_ptr<MessageChannel> ch_;
+	std::thread receiver_;
+
+	/** Tasks received but not yet explored */
+	std::deque<std::vector<std::uint8_t>> tasks_;
+	std::atomic<std::size_t> queuedBytes_{0};
+	bool shutdown_ = false;
+	std::mutex mtx_;
+	std::condition_variable cv_;
+
+	std::atomic<unsigned> idleHint_{0};
+	std::atomic<unsigned> workRequests_{0};
+	std::atomic<bool> shouldHalt_{false};
+
+#ifdef ENABLE_GENMC_DEBUG
+	unsigned explored_ = 0;
+	unsigned submitted_ = 0;
+	unsigned exitAfter_ = 0;
+	unsigned crashAfter_ = 0;
+#endif
+};
+
+#endif /* GENMC_DISTRIBUTED_POOL_HPP */
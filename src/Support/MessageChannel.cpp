@@ -0,0 +1,308 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#include "MessageChannel.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+/* A parsed channel address */
+struct Address {
+	bool isUnix;
+	std::string host; /* or path, for unix sockets */
+	std::string port;
+};
+
+auto parseAddress(const std::string &addr) -> std::optional<Address>
+{
+	if (addr.rfind("unix:", 0) == 0)
+		return Address{true, addr.substr(5), ""};
+
+	auto rest = addr.rfind("tcp:", 0) == 0 ? addr.substr(4) : addr;
+	auto colon = rest.rfind(':');
+	if (colon == std::string::npos || colon + 1 == rest.size())
+		return std::nullopt;
+
+	/* An empty host stands for the loopback interface */
+	auto host = rest.substr(0, colon);
+	return Address{false, host.empty() ? "127.0.0.1" : host, rest.substr(colon + 1)};
+}
+
+auto fillUnixAddress(const std::string &path, sockaddr_un &sa) -> bool
+{
+	if (path.empty() || path.size() >= sizeof(sa.sun_path))
+		return false;
+	std::memset(&sa, 0, sizeof(sa));
+	sa.sun_family = AF_UNIX;
+	std::memcpy(sa.sun_path, path.c_str(), path.size() + 1);
+	return true;
+}
+
+auto writeAll(int fd, const std::uint8_t *buf, std::size_t len) -> bool
+{
+	while (len > 0) {
+		auto n = ::send(fd, buf, len, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		buf += n;
+		len -= n;
+	}
+	return true;
+}
+
+auto readAll(int fd, std::uint8_t *buf, std::size_t len) -> bool
+{
+	while (len > 0) {
+		auto n = ::recv(fd, buf, len, 0);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		buf += n;
+		len -= n;
+	}
+	return true;
+}
+
+/* Like readAll(), but gives up if the data do not arrive by DEADLINE */
+auto readAllBy(int fd, std::uint8_t *buf, std::size_t len,
+	       std::chrono::steady_clock::time_point deadline) -> bool
+{
+	using namespace std::chrono;
+	while (len > 0) {
+		auto left = duration_cast<milliseconds>(deadline - steady_clock::now());
+		if (left.count() <= 0)
+			return false;
+		pollfd pfd{fd, POLLIN, 0};
+		auto r = poll(&pfd, 1, static_cast<int>(std::min<long long>(left.count(), 1000)));
+		if (r < 0 && errno == EINTR)
+			continue;
+		if (r < 0)
+			return false;
+		if (r == 0)
+			continue;
+		auto n = ::recv(fd, buf, len, MSG_DONTWAIT);
+		if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+			continue;
+		if (n <= 0)
+			return false;
+		buf += n;
+		len -= n;
+	}
+	return true;
+}
+
+auto decodeLength(const std::uint8_t *header) -> std::uint32_t
+{
+	return (static_cast<std::uint32_t>(header[0]) << 24) |
+	       (static_cast<std::uint32_t>(header[1]) << 16) |
+	       (static_cast<std::uint32_t>(header[2]) << 8) | header[3];
+}
+
+void setNoDelay(int fd)
+{
+	int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+} // namespace
+
+auto MessageChannel::connect(const std::string &addr) -> std::unique_ptr<MessageChannel>
+{
+	auto a = parseAddress(addr);
+	if (!a)
+		return nullptr;
+
+	if (a->isUnix) {
+		sockaddr_un sa{};
+		if (!fillUnixAddress(a->host, sa))
+			return nullptr;
+		auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+			return nullptr;
+		if (::connect(fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) < 0) {
+			close(fd);
+			return nullptr;
+		}
+		return std::make_unique<MessageChannel>(fd);
+	}
+
+	addrinfo hints{};
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo *res = nullptr;
+	if (getaddrinfo(a->host.c_str(), a->port.c_str(), &hints, &res) != 0)
+		return nullptr;
+
+	auto fd = -1;
+	for (auto *ai = res; ai; ai = ai->ai_next) {
+		fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+		if (fd < 0)
+			continue;
+		if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0)
+			break;
+		close(fd);
+		fd = -1;
+	}
+	freeaddrinfo(res);
+	if (fd < 0)
+		return nullptr;
+	setNoDelay(fd);
+	return std::make_unique<MessageChannel>(fd);
+}
+
+auto MessageChannel::createPair()
+	-> std::pair<std::unique_ptr<MessageChannel>, std::unique_ptr<MessageChannel>>
+{
+	int fds[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+		return {nullptr, nullptr};
+	return {std::make_unique<MessageChannel>(fds[0]), std::make_unique<MessageChannel>(fds[1])};
+}
+
+auto MessageChannel::send(std::uint8_t type, const std::vector<std::uint8_t> &payload) -> bool
+{
+	/* The length (which covers the type too) has to fit in the header */
+	if (payload.size() >= std::numeric_limits<std::uint32_t>::max())
+		return false;
+
+	auto len = static_cast<std::uint32_t>(payload.size() + 1);
+	std::uint8_t header[5] = {static_cast<std::uint8_t>(len >> 24),
+				  static_cast<std::uint8_t>(len >> 16),
+				  static_cast<std::uint8_t>(len >> 8), static_cast<std::uint8_t>(len),
+				  type};
+
+	std::lock_guard<std::mutex> lock(sendMtx_);
+	return writeAll(fd_, header, sizeof(header)) &&
+	       writeAll(fd_, payload.data(), payload.size());
+}
+
+auto MessageChannel::receive() -> std::optional<Message>
+{
+	std::uint8_t header[5];
+	if (!readAll(fd_, header, sizeof(header)))
+		return std::nullopt;
+
+	auto len = decodeLength(header);
+	if (len == 0)
+		return std::nullopt;
+
+	Message msg{header[4], std::vector<std::uint8_t>(len - 1)};
+	if (!readAll(fd_, msg.payload.data(), msg.payload.size()))
+		return std::nullopt;
+	return msg;
+}
+
+auto MessageChannel::receive(std::uint8_t type, std::size_t maxLen,
+			     std::chrono::steady_clock::time_point deadline)
+	-> std::optional<Message>
+{
+	std::uint8_t header[5];
+	if (!readAllBy(fd_, header, sizeof(header), deadline))
+		return std::nullopt;
+
+	/* Check the header before trusting the length */
+	auto len = decodeLength(header);
+	if (len == 0 || len - 1 > maxLen || header[4] != type)
+		return std::nullopt;
+
+	Message msg{header[4], std::vector<std::uint8_t>(len - 1)};
+	if (!readAllBy(fd_, msg.payload.data(), msg.payload.size(), deadline))
+		return std::nullopt;
+	return msg;
+}
+
+void MessageChannel::shutdown() { ::shutdown(fd_, SHUT_RDWR); }
+
+MessageChannel::~MessageChannel() { close(fd_); }
+
+auto MessageListener::listen(const std::string &addr) -> std::unique_ptr<MessageListener>
+{
+	auto a = parseAddress(addr);
+	if (!a)
+		return nullptr;
+
+	if (a->isUnix) {
+		sockaddr_un sa{};
+		if (!fillUnixAddress(a->host, sa))
+			return nullptr;
+		auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+			return nullptr;
+		unlink(a->host.c_str());
+		if (bind(fd, reinterpret_cast<sockaddr *>(&sa), sizeof(sa)) < 0 ||
+		    ::listen(fd, SOMAXCONN) < 0) {
+			close(fd);
+			return nullptr;
+		}
+		return std::unique_ptr<MessageListener>(new MessageListener(fd, a->host));
+	}
+
+	addrinfo hints{};
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo *res = nullptr;
+	if (getaddrinfo(a->host.c_str(), a->port.c_str(), &hints, &res) != 0)
+		return nullptr;
+
+	auto fd = -1;
+	for (auto *ai = res; ai; ai = ai->ai_next) {
+		fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+		if (fd < 0)
+			continue;
+		int one = 1;
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+		if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 && ::listen(fd, SOMAXCONN) == 0)
+			break;
+		close(fd);
+		fd = -1;
+	}
+	freeaddrinfo(res);
+	if (fd < 0)
+		return nullptr;
+	return std::unique_ptr<MessageListener>(new MessageListener(fd, ""));
+}
+
+auto MessageListener::accept() -> std::unique_ptr<MessageChannel>
+{
+	while (true) {
+		auto fd = ::accept(fd_, nullptr, nullptr);
+		if (fd < 0 && errno == EINTR)
+			continue;
+		if (fd < 0)
+			return nullptr;
+		if (unixPath_.empty())
+			setNoDelay(fd);
+		return std::make_unique<MessageChannel>(fd);
+	}
+}
+
+MessageListener::~MessageListener()
+{
+	close(fd_);
+	if (!unixPath_.empty())
+		unlink(unixPath_.c_str());
+}
@@ -0,0 +1,116 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#ifndef GENMC_MESSAGE_CHANNEL_HPP
+#define GENMC_MESSAGE_CHANNEL_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+/*******************************************************************************
+ **                           MessageChannel Class
+ ******************************************************************************/
+
+/**
+ * A bidirectional channel of framed messages over a stream socket.
+ * Each message consists of a 4-byte big-endian length (covering the type
+ * and the payload), a 1-byte type, and the payload.
+ * Sending is thread-safe; receiving should be done by a single thread.
+ */
+class MessageChannel {
+
+public:
+	struct Message {
+		std::uint8_t type;
+		std::vector<std::uint8_t> payload;
+	};
+
+	/** Takes ownership of the (connected) socket FD */
+	explicit MessageChannel(int fd) : fd_(fd) {}
+
+	MessageChannel(const MessageChannel &) = delete;
+	auto operator=(const MessageChannel &) -> MessageChannel & = delete;
+
+	/** Connects to ADDR, which is either "unix:PATH" or "[tcp:]HOST:PORT"
+	 * (where an empty HOST stands for the loopback interface).
+	 * Returns nullptr on failure */
+	static auto connect(const std::string &addr) -> std::unique_ptr<MessageChannel>;
+
+	/** Creates a pair of connected channels (e.g., to be used across fork()) */
+	static auto createPair()
+		-> std::pair<std::unique_ptr<MessageChannel>, std::unique_ptr<MessageChannel>>;
+
+	/** Sends a message. Returns false if the peer is gone, or if
+	 * the payload is too large (4GiB or more) to be sent */
+	auto send(std::uint8_t type, const std::vector<std::uint8_t> &payload = {}) -> bool;
+
+	/** Blocks until a message is received.
+	 * Returns std::nullopt if the peer closed the connection */
+	auto receive() -> std::optional<Message>;
+
+	/** Like receive(), but for untrusted peers: only accepts a message of
+	 * type TYPE whose payload is at most MAXLEN bytes, and only if it
+	 * arrives in full before DEADLINE. Otherwise, returns std::nullopt
+	 * without allocating space for the payload */
+	auto receive(std::uint8_t type, std::size_t maxLen,
+		     std::chrono::steady_clock::time_point deadline) -> std::optional<Message>;
+
+	/** Shuts down both directions of the channel, unblocking any
+	 * pending receive() */
+	void shutdown();
+
+	[[nodiscard]] auto getFd() const -> int { return fd_; }
+
+	~MessageChannel();
+
+private:
+	int fd_;
+	std::mutex sendMtx_;
+};
+
+/*******************************************************************************
+ **                           MessageListener Class
+ ******************************************************************************/
+
+/** Accepts incoming connections on an address (see MessageChannel::connect()) */
+class MessageListener {
+
+public:
+	/** Listens on ADDR. An empty host (e.g., ":PORT") stands for the
+	 * loopback interface; other interfaces have to be named explicitly
+	 * (e.g., "0.0.0.0:PORT"). Returns nullptr on failure */
+	static auto listen(const std::string &addr) -> std::unique_ptr<MessageListener>;
+
+	MessageListener(const MessageListener &) = delete;
+	auto operator=(const MessageListener &) -> MessageListener & = delete;
+
+	/** Blocks until a peer connects */
+	auto accept() -> std::unique_ptr<MessageChannel>;
+
+	[[nodiscard]] auto getFd() const -> int { return fd_; }
+
+	~MessageListener();
+
+private:
+	MessageListener(int fd, std::string path) : fd_(fd), unixPath_(std::move(path)) {}
+
+	int fd_;
+	std::string unixPath_; /**< Socket file to remove (if any) */
+};
+
+#endif /* GENMC_MESSAGE_CHANNEL_HPP */
@@ -38,6 +38,10 @@ public:
 	/** Whether we have any information stored */
 	[[nodiscard]] auto empty() const -> bool { return info.empty(); }
 
+	/** Iterators over the (offset, name) pairs, sorted by offset */
+	[[nodiscard]] auto begin() const { return info.begin(); }
+	[[nodiscard]] auto end() const { return info.end(); }
+
 	friend auto operator<<(llvm::raw_ostream &rhs, const NameInfo &info) -> llvm::raw_ostream &;
 
 private:
@@ -13,6 +13,7 @@
 
 #include "Support/SAddrAllocator.hpp"
 #include "ADT/VectorClock.hpp"
+#include "Support/Serialization.hpp"
 
 void SAddrAllocator::restrict(const VectorClock &view)
 {
@@ -21,6 +22,34 @@ void SAddrAllocator::restrict(const VectorClock &view)
 	}
 }
 
+void SAddrAllocator::serialize(ByteWriter &out) const
+{
+	out.writeU64(staticPool_.size());
+	for (const auto &[tid, idx] : staticPool_) {
+		out.writeU64(tid);
+		out.writeU64(idx);
+	}
+	out.writeU64(dynamicPool_.size());
+	for (const auto &[tid, idx] : dynamicPool_) {
+		out.writeU64(tid);
+		out.writeU64(static_cast<const SAddr::Width &>(idx));
+	}
+}
+
+auto SAddrAllocator::deserialize(ByteReader &in) -> SAddrAllocator
+{
+	SAddrAllocator result;
+	for (auto n = in.readU64(); n > 0; n--) {
+		auto tid = static_cast<unsigned>(in.readU64());
+		result.staticPool_[tid] = in.readU64();
+	}
+	for (auto n = in.readU64(); n > 0; n--) {
+		auto tid = static_cast<unsigned>(in.readU64());
+		result.dynamicPool_[tid] = WidthProxy(in.readU64());
+	}
+	return result;
+}
+
 auto operator<<(llvm::raw_ostream &rhs, const SAddrAllocator &alloctor) -> llvm::raw_ostream &
 {
 	rhs << "static: ";
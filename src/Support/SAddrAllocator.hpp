@@ -20,6 +20,8 @@
 #include <unordered_map>
 
 class VectorClock;
+class ByteWriter;
+class ByteReader;
 
 /*******************************************************************************
  **                         SAddrAllocator Class
@@ -69,6 +71,10 @@ public:
 
 	void restrict(const VectorClock &view);
 
+	/** Serialization facilities (see Support/Serialization.hpp) */
+	void serialize(ByteWriter &out) const;
+	static auto deserialize(ByteReader &in) -> SAddrAllocator;
+
 	friend auto operator<<(llvm::raw_ostream &rhs, const SAddrAllocator &alloctor)
 		-> llvm::raw_ostream &;
 
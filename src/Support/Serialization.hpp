@@ -0,0 +1,155 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#ifndef GENMC_SERIALIZATION_HPP
+#define GENMC_SERIALIZATION_HPP
+
+#include "Support/Error.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*******************************************************************************
+ **                           ByteWriter Class
+ ******************************************************************************/
+
+/**
+ * Appends binary data to a byte buffer. Integers are encoded as LEB128
+ * varints (signed ones after a zig-zag transformation), so that the small
+ * values that dominate execution graphs (thread ids, indices, etc) take up
+ * a single byte. The encoding does not depend on the host's endianness.
+ */
+class ByteWriter {
+
+public:
+	ByteWriter() = default;
+
+	void writeU64(std::uint64_t v)
+	{
+		while (v >= 0x80) {
+			buf_.push_back(static_cast<std::uint8_t>(v | 0x80));
+			v >>= 7;
+		}
+		buf_.push_back(static_cast<std::uint8_t>(v));
+	}
+
+	void writeS64(std::int64_t v)
+	{
+		writeU64((static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63));
+	}
+
+	void writeBool(bool b) { buf_.push_back(b ? 1 : 0); }
+
+	template <typename E>
+		requires std::is_enum_v<E>
+	void writeEnum(E e)
+	{
+		writeS64(static_cast<std::int64_t>(e));
+	}
+
+	void writeBytes(const void *data, std::size_t size)
+	{
+		writeU64(size);
+		const auto *bytes = static_cast<const std::uint8_t *>(data);
+		buf_.insert(buf_.end(), bytes, bytes + size);
+	}
+
+	void writeString(const std::string &s) { writeBytes(s.data(), s.size()); }
+
+	/** Returns the number of bytes written so far */
+	[[nodiscard]] auto size() const -> std::size_t { return buf_.size(); }
+
+	[[nodiscard]] auto data() const -> const std::vector<std::uint8_t> & { return buf_; }
+
+	/** Moves the written bytes out of the writer */
+	auto take() -> std::vector<std::uint8_t> { return std::move(buf_); }
+
+private:
+	std::vector<std::uint8_t> buf_;
+};
+
+/*******************************************************************************
+ **                           ByteReader Class
+ ******************************************************************************/
+
+/**
+ * Reads back data written by a ByteWriter. The reader does not own the
+ * underlying buffer. Malformed (e.g., truncated) input is a user error:
+ * it can only come from a corrupted file or a misbehaving peer.
+ */
+class ByteReader {
+
+public:
+	ByteReader(const std::uint8_t *data, std::size_t size) : data_(data), size_(size) {}
+	explicit ByteReader(const std::vector<std::uint8_t> &buf)
+		: ByteReader(buf.data(), buf.size())
+	{}
+
+	auto readU64() -> std::uint64_t
+	{
+		std::uint64_t v = 0;
+		for (auto shift = 0U; shift < 64; shift += 7) {
+			auto byte = readByte();
+			v |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return v;
+		}
+		ERROR("Malformed serialized data (overlong integer)!\n");
+	}
+
+	auto readS64() -> std::int64_t
+	{
+		auto v = readU64();
+		return static_cast<std::int64_t>((v >> 1) ^ (~(v & 1) + 1));
+	}
+
+	auto readBool() -> bool { return readByte() != 0; }
+
+	template <typename E>
+		requires std::is_enum_v<E>
+	auto readEnum() -> E
+	{
+		return static_cast<E>(readS64());
+	}
+
+	auto readString() -> std::string
+	{
+		auto len = readU64();
+		ERROR_ON(len > remaining(), "Malformed serialized data (truncated)!\n");
+		std::string s(reinterpret_cast<const char *>(data_ + pos_), len);
+		pos_ += len;
+		return s;
+	}
+
+	/** Returns the number of bytes not consumed yet */
+	[[nodiscard]] auto remaining() const -> std::size_t { return size_ - pos_; }
+
+	/** Whether all input has been consumed */
+	[[nodiscard]] auto atEnd() const -> bool { return pos_ == size_; }
+
+private:
+	auto readByte() -> std::uint8_t
+	{
+		ERROR_ON(pos_ >= size_, "Malformed serialized data (truncated)!\n");
+		return data_[pos_++];
+	}
+
+	const std::uint8_t *data_;
+	std::size_t size_;
+	std::size_t pos_ = 0;
+};
+
+#endif /* GENMC_SERIALIZATION_HPP */
@@ -0,0 +1,429 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#include "SlabAllocator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+
+struct SlabAllocator::FreeNode {
+	FreeNode *next;
+};
+
+/* Resides at the beginning of each chunk. Chunks are aligned to their size,
+ * so that the chunk of an object can be found from the object's address */
+struct SlabAllocator::ChunkHeader {
+	/* The objects of the chunk that are not in the depot (i.e., in use or
+	 * in some thread's free list), plus one while objects are carved out
+	 * of the chunk. Only drops to zero while the depot is locked */
+	std::atomic<std::size_t> held{1};
+
+	/* HELD of the chunks of regions, which are never carved into slabs */
+	static constexpr auto inRegion = std::numeric_limits<std::size_t>::max() - 1;
+
+	/* Links chunks that are about to be released (or spare region chunks) */
+	ChunkHeader *nextReleased = nullptr;
+
+	/* For the chunks of regions: the region, and how many of the objects
+	 * carved out of the chunk have not been freed yet */
+	Region *region = nullptr;
+	std::size_t live = 0;
+};
+
+/* Trivially destructible, so that objects freed during the destruction
+ * of other thread-local objects can still be handled */
+struct SlabAllocator::ThreadCache {
+	std::array<FreeNode *, numClasses> free{};
+	std::array<std::size_t, numClasses> count{}; /**< Length of each free list */
+	std::array<char *, numClasses> cur{};	     /**< Unused part of the current chunks */
+	std::array<char *, numClasses> end{};
+	ChunkHeader *spareChunks = nullptr; /**< Empty region chunks (see Region) */
+	std::size_t numSpareChunks = 0;
+	bool registered = false;
+	bool dead = false; /**< Whether the thread is exiting */
+};
+
+/* Free objects handed over by the threads */
+struct SlabAllocator::Depot {
+	std::mutex mtx;
+	std::array<FreeNode *, numClasses> free{};
+	std::array<std::atomic<std::size_t>, numClasses> count{}; /**< Also read unlocked */
+
+	/* Chunks all objects of which are in the respective free list */
+	std::array<std::size_t, numClasses> emptyChunks{};
+};
+
+struct SlabAllocator::CacheFlusher {
+	~CacheFlusher() { flush(cache_); }
+};
+
+thread_local SlabAllocator::ThreadCache SlabAllocator::cache_;
+thread_local SlabAllocator::CacheFlusher SlabAllocator::flusher_;
+SlabAllocator::Depot SlabAllocator::depot_;
+
+auto SlabAllocator::getChunk(const void *p) -> ChunkHeader *
+{
+	static_assert(sizeof(ChunkHeader) <= headerSize);
+	return reinterpret_cast<ChunkHeader *>(reinterpret_cast<std::uintptr_t>(p) &
+					       ~static_cast<std::uintptr_t>(chunkSize - 1));
+}
+
+auto SlabAllocator::getCache() -> ThreadCache &
+{
+	auto &cache = cache_;
+	if (!cache.registered) {
+		/* Odr-using the flusher constructs it, and registers its destructor */
+		cache.registered = true;
+		(void)&flusher_;
+	}
+	return cache;
+}
+
+auto SlabAllocator::allocate(std::size_t size) -> void *
+{
+	if (size > maxSize)
+		return ::operator new(size);
+
+	auto cls = getSizeClass(size);
+	auto &cache = getCache();
+	if (auto *node = cache.free[cls]) {
+		cache.free[cls] = node->next;
+		--cache.count[cls];
+		return node;
+	}
+	return refill(cache, cls);
+}
+
+void SlabAllocator::putObjects(std::size_t cls, FreeNode *head, std::size_t n)
+{
+	auto *tail = head;
+	for (auto i = 0U; i < n; i++) {
+		if (getChunk(tail)->held.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			++depot_.emptyChunks[cls];
+		if (i + 1 < n)
+			tail = tail->next;
+	}
+	tail->next = depot_.free[cls];
+	depot_.free[cls] = head;
+	depot_.count[cls] += n;
+}
+
+auto SlabAllocator::takeObjects(std::size_t cls, std::size_t n) -> std::pair<FreeNode *, std::size_t>
+{
+	auto *head = depot_.free[cls];
+	if (!head)
+		return {nullptr, 0};
+
+	auto taken = 1U;
+	auto *tail = head;
+	getChunk(tail)->held.fetch_add(1, std::memory_order_relaxed);
+	while (taken < n && tail->next) {
+		tail = tail->next;
+		getChunk(tail)->held.fetch_add(1, std::memory_order_relaxed);
+		++taken;
+	}
+	depot_.free[cls] = tail->next;
+	depot_.count[cls] -= taken;
+	tail->next = nullptr;
+	return {head, taken};
+}
+
+void SlabAllocator::releaseEmptyChunks(std::size_t cls)
+{
+	/* Only scan the free list if the empty chunks make up for a good
+	 * part of it, so that it is not scanned over and over again */
+	auto perChunk = chunkSize / getObjectSize(cls);
+	auto &empty = depot_.emptyChunks[cls];
+	if (empty == 0 || 4 * empty * perChunk < depot_.count[cls])
+		return;
+
+	/* Unlink the objects of empty chunks (marking the chunks as released) */
+	static constexpr auto released = std::numeric_limits<std::size_t>::max();
+	ChunkHeader *chunks = nullptr;
+	auto **link = &depot_.free[cls];
+	while (auto *node = *link) {
+		auto *chunk = getChunk(node);
+		auto held = chunk->held.load(std::memory_order_relaxed);
+		if (held != 0 && held != released) {
+			link = &node->next;
+			continue;
+		}
+		if (held == 0) {
+			chunk->held.store(released, std::memory_order_relaxed);
+			chunk->nextReleased = chunks;
+			chunks = chunk;
+		}
+		*link = node->next;
+		--depot_.count[cls];
+	}
+	empty = 0;
+
+	while (chunks) {
+		auto *next = chunks->nextReleased;
+		chunks->~ChunkHeader();
+		::operator delete(chunks, std::align_val_t(chunkSize));
+		chunks = next;
+	}
+}
+
+void SlabAllocator::deallocate(void *p, std::size_t size) noexcept
+{
+	if (size > maxSize) {
+		::operator delete(p);
+		return;
+	}
+
+	if (auto *chunk = getChunk(p);
+	    chunk->held.load(std::memory_order_relaxed) == ChunkHeader::inRegion) {
+		chunk->region->deallocate(chunk, static_cast<char *>(p), size);
+		return;
+	}
+
+	auto cls = getSizeClass(size);
+	auto *node = static_cast<FreeNode *>(p);
+	auto &cache = getCache();
+	if (cache.dead) {
+		std::lock_guard<std::mutex> lock(depot_.mtx);
+		putObjects(cls, node, 1);
+		releaseEmptyChunks(cls);
+		return;
+	}
+	node->next = cache.free[cls];
+	cache.free[cls] = node;
+	if (++cache.count[cls] > getHighWater(cls))
+		trim(cache, cls);
+}
+
+void SlabAllocator::trim(ThreadCache &cache, std::size_t cls)
+{
+	/* Keep half of the objects, in case we are about to allocate again */
+	auto keep = getHighWater(cls) / 2;
+	if (cache.count[cls] <= keep)
+		return;
+
+	auto *head = cache.free[cls];
+	FreeNode *tail = nullptr;
+	for (auto i = 0U; i < keep; i++) {
+		tail = head;
+		head = head->next;
+	}
+	if (tail)
+		tail->next = nullptr;
+	else
+		cache.free[cls] = nullptr;
+
+	auto n = cache.count[cls] - keep;
+	cache.count[cls] = keep;
+
+	std::lock_guard<std::mutex> lock(depot_.mtx);
+	putObjects(cls, head, n);
+	releaseEmptyChunks(cls);
+}
+
+void SlabAllocator::retireChunk(ThreadCache &cache, std::size_t cls)
+{
+	if (!cache.cur[cls])
+		return;
+
+	auto *chunk = getChunk(cache.cur[cls] - 1);
+	cache.cur[cls] = nullptr;
+	cache.end[cls] = nullptr;
+
+	std::lock_guard<std::mutex> lock(depot_.mtx);
+	if (chunk->held.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		++depot_.emptyChunks[cls];
+		releaseEmptyChunks(cls);
+	}
+}
+
+auto SlabAllocator::refill(ThreadCache &cache, std::size_t cls) -> void *
+{
+	/* Prefer objects handed over by other threads... */
+	if (depot_.count[cls].load(std::memory_order_relaxed) > 0) {
+		std::lock_guard<std::mutex> lock(depot_.mtx);
+		auto batch = cache.dead ? 1 : std::max<std::size_t>(getHighWater(cls) / 2, 1);
+		if (auto [list, n] = takeObjects(cls, batch); list) {
+			cache.free[cls] = list->next;
+			cache.count[cls] = n - 1;
+			return list;
+		}
+	}
+
+	/* ... and otherwise carve a new object out of the current chunk */
+	auto objSize = getObjectSize(cls);
+	if (cache.cur[cls] == nullptr ||
+	    cache.end[cls] - cache.cur[cls] < static_cast<std::ptrdiff_t>(objSize)) {
+		retireChunk(cache, cls);
+		auto *chunk = ::operator new(chunkSize, std::align_val_t(chunkSize));
+		new (chunk) ChunkHeader();
+		cache.cur[cls] = static_cast<char *>(chunk) + headerSize;
+		cache.end[cls] = static_cast<char *>(chunk) + chunkSize;
+	}
+	auto *p = cache.cur[cls];
+	cache.cur[cls] += objSize;
+	getChunk(p)->held.fetch_add(1, std::memory_order_relaxed);
+
+	/* Exiting threads cannot hand their chunks over later */
+	if (cache.dead)
+		retireChunk(cache, cls);
+	return p;
+}
+
+void SlabAllocator::flush(ThreadCache &cache)
+{
+	cache.dead = true;
+	while (auto *chunk = cache.spareChunks) {
+		cache.spareChunks = chunk->nextReleased;
+		chunk->~ChunkHeader();
+		::operator delete(chunk, std::align_val_t(chunkSize));
+	}
+	cache.numSpareChunks = 0;
+
+	for (auto cls = 0U; cls < numClasses; cls++) {
+		retireChunk(cache, cls);
+		if (!cache.free[cls])
+			continue;
+
+		std::lock_guard<std::mutex> lock(depot_.mtx);
+		putObjects(cls, cache.free[cls], cache.count[cls]);
+		releaseEmptyChunks(cls);
+		cache.free[cls] = nullptr;
+		cache.count[cls] = 0;
+	}
+}
+
+auto SlabAllocator::Region::allocate(std::size_t size) -> void *
+{
+	if (size > maxSize)
+		return ::operator new(size);
+
+	size = getObjectSize(getSizeClass(size));
+	if (!cur_ || end_ - cur_ < static_cast<std::ptrdiff_t>(size))
+		nextChunk();
+	auto *p = cur_;
+	cur_ += size;
+	++getChunk(p)->live;
+	return p;
+}
+
+void SlabAllocator::Region::deallocate(ChunkHeader *chunk, char *p, std::size_t size) noexcept
+{
+	auto *base = reinterpret_cast<char *>(chunk);
+	--chunk->live;
+	if (!cur_ || base != chunks_[current_]) {
+		if (chunk->live == 0)
+			releaseChunk(chunk);
+		return;
+	}
+
+	/* The current chunk is kept around; reuse what is freed at its end */
+	if (chunk->live == 0)
+		cur_ = base + headerSize;
+	else if (p + getObjectSize(getSizeClass(size)) == cur_)
+		cur_ = p;
+}
+
+void SlabAllocator::Region::reserve(std::size_t n, std::size_t bytes)
+{
+	/* Objects are rounded up, and do not straddle chunks, so at most
+	 * maxSize bytes of each chunk may be left unused */
+	static constexpr auto perChunk = chunkSize - headerSize - maxSize;
+
+	auto needed = bytes + n * (granularity - 1);
+	auto spare = chunks_.size() - current_ - (cur_ ? 1 : 0);
+	auto room = static_cast<std::size_t>(end_ - cur_) + spare * perChunk;
+	for (; room < needed; room += perChunk)
+		addChunk();
+}
+
+void SlabAllocator::Region::swap(Region &other) noexcept
+{
+	std::swap(chunks_, other.chunks_);
+	std::swap(current_, other.current_);
+	std::swap(cur_, other.cur_);
+	std::swap(end_, other.end_);
+
+	/* Objects that are freed later have to find their new region */
+	for (auto *chunk : chunks_)
+		reinterpret_cast<ChunkHeader *>(chunk)->region = this;
+	for (auto *chunk : other.chunks_)
+		reinterpret_cast<ChunkHeader *>(chunk)->region = &other;
+}
+
+void SlabAllocator::Region::addChunk()
+{
+	/* Prefer chunks that regions of this thread released: a fresh
+	 * chunk has to be faulted in page by page */
+	auto &cache = getCache();
+	auto *chunk = cache.spareChunks;
+	if (chunk) {
+		cache.spareChunks = chunk->nextReleased;
+		--cache.numSpareChunks;
+	} else {
+		chunk = new (::operator new(chunkSize, std::align_val_t(chunkSize))) ChunkHeader();
+		chunk->held.store(ChunkHeader::inRegion, std::memory_order_relaxed);
+	}
+	chunk->region = this;
+	chunk->live = 0;
+	chunks_.push_back(reinterpret_cast<char *>(chunk));
+}
+
+void SlabAllocator::Region::nextChunk()
+{
+	if (cur_)
+		++current_;
+	if (current_ == chunks_.size())
+		addChunk();
+	cur_ = chunks_[current_] + headerSize;
+	end_ = chunks_[current_] + chunkSize;
+}
+
+auto SlabAllocator::Region::contains(const void *p, std::size_t size) -> bool
+{
+	return size <= maxSize &&
+	       getChunk(p)->held.load(std::memory_order_relaxed) == ChunkHeader::inRegion;
+}
+
+void SlabAllocator::Region::release(std::size_t n) noexcept
+{
+	for (auto i = n; i < chunks_.size(); i++)
+		recycleChunk(reinterpret_cast<ChunkHeader *>(chunks_[i]));
+	chunks_.resize(n);
+}
+
+void SlabAllocator::Region::releaseChunk(ChunkHeader *chunk) noexcept
+{
+	auto it = std::find(chunks_.begin(), chunks_.end(), reinterpret_cast<char *>(chunk));
+	if (static_cast<std::size_t>(std::distance(chunks_.begin(), it)) < current_)
+		--current_;
+	chunks_.erase(it);
+	recycleChunk(chunk);
+}
+
+void SlabAllocator::Region::recycleChunk(ChunkHeader *chunk) noexcept
+{
+	auto &cache = getCache();
+	if (!cache.dead && cache.numSpareChunks < maxSpareChunks) {
+		chunk->nextReleased = cache.spareChunks;
+		cache.spareChunks = chunk;
+		++cache.numSpareChunks;
+		return;
+	}
+	chunk->~ChunkHeader();
+	::operator delete(chunk, std::align_val_t(chunkSize));
+}
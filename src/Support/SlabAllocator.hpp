@@ -0,0 +1,217 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#ifndef GENMC_SLAB_ALLOCATOR_HPP
+#define GENMC_SLAB_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/*******************************************************************************
+ **                         SlabAllocator Class
+ ******************************************************************************/
+
+/**
+ * An allocator for small objects that are created and destroyed in large
+ * numbers (e.g., event labels). Objects are grouped in size classes and
+ * carved out of large chunks (each holding objects of a single class);
+ * freed objects are kept in per-thread free lists, so that both allocation
+ * and deallocation are (usually) a couple of pointer operations.
+ *
+ * An object may be freed by a different thread than the one that allocated
+ * it. Once a thread holds more free objects of a class than it is likely to
+ * reuse, it hands the surplus over to a shared depot, from which the other
+ * threads refill their lists. The same happens to all free lists of a thread
+ * when it exits. Chunks all objects of which end up in the depot are returned
+ * to the system.
+ *
+ * Objects can also be allocated from a Region, which reclaims them in bulk.
+ */
+class SlabAllocator {
+
+	struct ChunkHeader;
+
+public:
+	SlabAllocator() = delete;
+
+	/** Allocates SIZE bytes (aligned to at least alignof(std::max_align_t)) */
+	static auto allocate(std::size_t size) -> void *;
+
+	/** Frees P, which was allocated with SIZE bytes (possibly from a region) */
+	static void deallocate(void *p, std::size_t size) noexcept;
+
+	/**
+	 * Objects allocated one after the other, and reclaimed together: an
+	 * object is carved out of the region's chunks right after the previous
+	 * one. Objects freed individually are only reclaimed along with the rest
+	 * of their chunk: a chunk is released as soon as all its objects are
+	 * freed, and the last object allocated is reclaimed right away (so that
+	 * freeing objects in reverse order rewinds the region). All objects are
+	 * reclaimed when the region is destroyed, and must thus be destroyed
+	 * before the region.
+	 *
+	 * A region is not thread-safe, and is meant to be owned by a single
+	 * data structure (e.g., the labels of an execution graph). Objects
+	 * larger than the slabs' limit are allocated individually, as usual.
+	 * Each thread keeps a few of the chunks released by regions around,
+	 * so that short-lived regions do not keep faulting in fresh memory.
+	 */
+	class Region {
+	public:
+		Region() = default;
+		Region(const Region &) = delete;
+		Region(Region &&other) noexcept { swap(other); }
+
+		auto operator=(const Region &) -> Region & = delete;
+
+		/* Swaps rather than frees the chunks of this region: objects
+		 * in them may still be alive (e.g., in a member declared after
+		 * the region), and are now reclaimed along with OTHER */
+		auto operator=(Region &&other) noexcept -> Region &
+		{
+			swap(other);
+			return *this;
+		}
+
+		~Region() { release(0); }
+
+		/** Allocates SIZE bytes */
+		auto allocate(std::size_t size) -> void *;
+
+		/** Makes room for N objects of BYTES bytes in total in advance */
+		void reserve(std::size_t n, std::size_t bytes);
+
+		/** Returns the number of bytes below which objects are better
+		 * allocated from the slabs (a region holds at least a chunk) */
+		static constexpr auto getMinBytes() -> std::size_t { return chunkSize / 4; }
+
+		/** Returns the number of bytes held by the region's chunks */
+		[[nodiscard]] auto getMemoryUsage() const -> std::size_t
+		{
+			return chunks_.size() * chunkSize;
+		}
+
+		/** Whether P (an object of SIZE bytes) was allocated from a region */
+		static auto contains(const void *p, std::size_t size) -> bool;
+
+	private:
+		friend class SlabAllocator;
+
+		/** Swaps the chunks of this region with the ones of OTHER */
+		void swap(Region &other) noexcept;
+
+		/** Reclaims P, an object of SIZE bytes in CHUNK (one of this
+		 * region's chunks) */
+		void deallocate(ChunkHeader *chunk, char *p, std::size_t size) noexcept;
+
+		/** Adds a new (empty) chunk at the end of the region */
+		void addChunk();
+
+		/** Moves to the next chunk, adding one if needed */
+		void nextChunk();
+
+		/** Returns the chunks from the N-th on to the system */
+		void release(std::size_t n) noexcept;
+
+		/** Returns CHUNK (which is not the current one) to the system */
+		void releaseChunk(ChunkHeader *chunk) noexcept;
+
+		/** Keeps CHUNK (no longer part of a region) as a spare chunk of
+		 * the calling thread, or returns it to the system */
+		static void recycleChunk(ChunkHeader *chunk) noexcept;
+
+		/** All chunks of the region (the ones after the current one
+		 * have been reserved, and are still empty) */
+		std::vector<char *> chunks_;
+		std::size_t current_ = 0;
+
+		/** Unused part of the current chunk */
+		char *cur_ = nullptr;
+		char *end_ = nullptr;
+	};
+
+private:
+	/** Larger objects are allocated with the global operator new */
+	static constexpr std::size_t granularity = alignof(std::max_align_t);
+	static constexpr std::size_t maxSize = 512;
+	static constexpr std::size_t numClasses = maxSize / granularity;
+	static constexpr std::size_t chunkSize = 64 * 1024;
+
+	/** Each chunk starts with a header (see ChunkHeader) */
+	static constexpr std::size_t headerSize = 2 * granularity;
+
+	/** How many bytes worth of free objects of a class a thread keeps
+	 * before handing (half of) them over to the depot */
+	static constexpr std::size_t highWaterBytes = 1024 * 1024;
+
+	/** How many empty region chunks a thread keeps for reuse */
+	static constexpr std::size_t maxSpareChunks = 64;
+
+	struct FreeNode;
+	struct ThreadCache;
+	struct Depot;
+	struct CacheFlusher;
+
+	static auto getSizeClass(std::size_t size) -> std::size_t
+	{
+		return (size + granularity - 1) / granularity - 1;
+	}
+
+	static auto getObjectSize(std::size_t cls) -> std::size_t
+	{
+		return (cls + 1) * granularity;
+	}
+
+	static auto getHighWater(std::size_t cls) -> std::size_t
+	{
+		return highWaterBytes / getObjectSize(cls);
+	}
+
+	/** Returns the chunk that P was carved out of */
+	static auto getChunk(const void *p) -> ChunkHeader *;
+
+	/** Returns the calling thread's cache (making sure that it
+	 * will be flushed when the thread exits) */
+	static auto getCache() -> ThreadCache &;
+
+	/** Fetches a new object of class CLS when CACHE has none */
+	static auto refill(ThreadCache &cache, std::size_t cls) -> void *;
+
+	/** Hands the surplus free objects of class CLS of CACHE over to the depot */
+	static void trim(ThreadCache &cache, std::size_t cls);
+
+	/** Stops carving objects of class CLS out of the current chunk of CACHE */
+	static void retireChunk(ThreadCache &cache, std::size_t cls);
+
+	/** Hands all free lists (and chunks) of CACHE over to the depot */
+	static void flush(ThreadCache &cache);
+
+	/* Depot operations; these expect the depot to be locked */
+
+	/** Prepends the list HEAD of N objects of class CLS to the depot */
+	static void putObjects(std::size_t cls, FreeNode *head, std::size_t n);
+
+	/** Takes (at most) N objects of class CLS from the depot.
+	 * Returns the list of the taken objects, and its length */
+	static auto takeObjects(std::size_t cls, std::size_t n) -> std::pair<FreeNode *, std::size_t>;
+
+	/** Returns empty chunks of class CLS to the system */
+	static void releaseEmptyChunks(std::size_t cls);
+
+	static thread_local ThreadCache cache_;
+	static thread_local CacheFlusher flusher_;
+	static Depot depot_;
+};
+
+#endif /* GENMC_SLAB_ALLOCATOR_HPP */
@@ -0,0 +1,73 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#include "SpillFile.hpp"
+#include "Support/Error.hpp"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+
+#include <cerrno>
+#include <unistd.h>
+
+auto SpillFile::write(const std::vector<std::uint8_t> &data) -> Record
+{
+	if (fd_ == -1) {
+		llvm::SmallString<128> path;
+		auto err = llvm::sys::fs::createTemporaryFile("genmc-spill", "bin", fd_, path);
+		ERROR_ON(err, "Could not create spill file: " << err.message() << "\n");
+		llvm::sys::fs::remove(path);
+	}
+
+	Record r{end_, data.size()};
+	for (auto done = 0UL; done < data.size();) {
+		auto n = ::pwrite(fd_, data.data() + done, data.size() - done, end_ + done);
+		if (n < 0 && errno == EINTR)
+			continue;
+		ERROR_ON(n <= 0, "Could not write to spill file!\n");
+		done += n;
+	}
+	end_ += data.size();
+	return r;
+}
+
+auto SpillFile::read(Record r) const -> std::vector<std::uint8_t>
+{
+	BUG_ON(r.offset + r.size > end_);
+
+	std::vector<std::uint8_t> data(r.size);
+	for (auto done = 0UL; done < r.size;) {
+		auto n = ::pread(fd_, data.data() + done, r.size - done, r.offset + done);
+		if (n < 0 && errno == EINTR)
+			continue;
+		ERROR_ON(n <= 0, "Could not read from spill file!\n");
+		done += n;
+	}
+	return data;
+}
+
+void SpillFile::drop(Record r)
+{
+	BUG_ON(r.offset > end_);
+	end_ = r.offset;
+
+	/* Give the space back, but avoid shrinking the file too often */
+	if (end_ == 0 && fd_ != -1)
+		(void)::ftruncate(fd_, 0);
+}
+
+SpillFile::~SpillFile()
+{
+	if (fd_ != -1)
+		::close(fd_);
+}
@@ -0,0 +1,66 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#ifndef GENMC_SPILL_FILE_HPP
+#define GENMC_SPILL_FILE_HPP
+
+#include <cstdint>
+#include <vector>
+
+/*******************************************************************************
+ **                             SpillFile Class
+ ******************************************************************************/
+
+/**
+ * A temporary file where byte buffers can be spilled to reduce memory usage.
+ * Records are appended, and are expected to be dropped in LIFO order
+ * (e.g., as the inactive entries of a stack), so that the file can shrink.
+ * The file is unlinked right after it is created, and is only materialized
+ * when the first record is written.
+ */
+class SpillFile {
+
+public:
+	/** Identifies a record in the file */
+	struct Record {
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+
+	SpillFile() = default;
+
+	SpillFile(const SpillFile &) = delete;
+	auto operator=(const SpillFile &) -> SpillFile & = delete;
+
+	/** Appends DATA to the file and returns the respective record */
+	auto write(const std::vector<std::uint8_t> &data) -> Record;
+
+	/** Reads back the data of record R */
+	[[nodiscard]] auto read(Record r) const -> std::vector<std::uint8_t>;
+
+	/** Drops record R, along with all records written after it */
+	void drop(Record r);
+
+	/** Drops all records */
+	void clear() { end_ = 0; }
+
+	~SpillFile();
+
+private:
+	int fd_ = -1;
+
+	/** The end of the last (live) record */
+	std::uint64_t end_ = 0;
+};
+
+#endif /* GENMC_SPILL_FILE_HPP */
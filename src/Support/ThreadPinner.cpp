@@ -14,6 +14,8 @@
 #include "ThreadPinner.hpp"
 #include "Error.hpp"
 
+#include <algorithm>
+
 #ifdef HAVE_LIBHWLOC
 
 ThreadPinner::ThreadPinner(unsigned int n) : numTasks(n)
@@ -31,6 +33,18 @@ ThreadPinner::ThreadPinner(unsigned int n) : numTasks(n)
 	/* Minimize migration costs */
 	for (int i = 0; i < numTasks; i++)
 		hwloc_bitmap_singlify(cpusets[i]);
+
+	/* Record the NUMA node of each CPU */
+	numNodes = std::max(1, hwloc_get_nbobjs_by_type(topology, HWLOC_OBJ_NUMANODE));
+	nodes.resize(n);
+	hwloc_nodeset_t nodeset = hwloc_bitmap_alloc();
+	for (int i = 0; i < numTasks; i++) {
+		hwloc_cpuset_to_nodeset(topology, cpusets[i], nodeset);
+		auto node = hwloc_get_numanode_obj_by_os_index(topology,
+							       hwloc_bitmap_first(nodeset));
+		nodes[i] = node ? node->logical_index : 0;
+	}
+	hwloc_bitmap_free(nodeset);
 }
 
 void ThreadPinner::pin(std::thread &t, unsigned int cpu)
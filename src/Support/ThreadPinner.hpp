@@ -38,6 +38,12 @@ public:
 
 	void pin(std::thread &t, unsigned int cpu);
 
+	/** Returns the NUMA node of the CPU a task is pinned to */
+	auto getNode(unsigned int cpu) const -> unsigned int { return nodes[cpu]; }
+
+	/** Returns the number of NUMA nodes in the machine */
+	auto getNumNodes() const -> unsigned int { return numNodes; }
+
 	/*** Destructor ***/
 	~ThreadPinner()
 	{
@@ -50,6 +56,8 @@ private:
 	unsigned int numTasks;
 	hwloc_topology_t topology;
 	std::vector<hwloc_cpuset_t> cpusets;
+	std::vector<unsigned int> nodes;
+	unsigned int numNodes = 1;
 };
 
 #else /* !HAVE_LIBHWLOC */
@@ -64,6 +72,10 @@ public:
 
 	void pin(std::thread &t, unsigned int cpu) {}
 
+	auto getNode(unsigned int cpu) const -> unsigned int { return 0; }
+
+	auto getNumNodes() const -> unsigned int { return 1; }
+
 	/*** Destructor ***/
 	~ThreadPinner() {}
 };
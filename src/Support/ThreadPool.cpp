@@ -14,30 +14,63 @@
 #include "ThreadPool.hpp"
 #include "Verification/VerificationResult.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+
+thread_local unsigned int ThreadPool::index_ = std::numeric_limits<unsigned int>::max();
+
 void ThreadPool::addWorker(unsigned int i, std::unique_ptr<GenMCDriver> driver,
 			   std::unique_ptr<llvm::Interpreter> EE, TFunT threadFun)
 {
 	using ThreadT = std::packaged_task<VerificationResult(
-		unsigned int, std::unique_ptr<GenMCDriver> driver,
-		std::unique_ptr<llvm::Interpreter> EE, TFunT threadFun)>;
+		unsigned int, GenMCDriver * driver, llvm::Interpreter * EE, TFunT threadFun)>;
 
-	ThreadT thread([this](unsigned int /*i*/, std::unique_ptr<GenMCDriver> driver,
-			      std::unique_ptr<llvm::Interpreter> EE, TFunT threadFun) {
+	ThreadT thread([this](unsigned int i, GenMCDriver *driver, llvm::Interpreter *EE,
+			      TFunT threadFun) {
+		setIndex(i);
+		auto &times = workerTimes_[i];
 		while (true) {
+			auto idleStart = std::chrono::steady_clock::now();
 			auto taskUP = popTask();
+			auto start = std::chrono::steady_clock::now();
+			times.idle += start - idleStart;
 
 			/* If the state is empty, nothing left to do */
 			if (!taskUP)
 				break;
 
-			/* Prepare the driver and start the exploration */
+			/* Remember which task we explore, so that its result
+			 * and the tasks it submits can be identified */
+			auto deterministic = policy_ == ParallelPolicy::Deterministic;
+			if (deterministic)
+				currentTasks_[i] = {std::move(taskUP->taskId), 0};
+
+			/* Prepare the driver and start the exploration.
+			 * Donated states carry revisits of an already explored
+			 * graph, so we have to pick one of those first */
 			driver->initFromState(std::move(taskUP));
-			threadFun(&*driver, &*EE);
+			if (!shouldHalt() &&
+			    (driver->getExec().getWorkqueue().empty() || !driver->done()))
+				threadFun(driver, EE);
+			if (deterministic) {
+				auto tres = driver->takeResult();
+				std::lock_guard<std::mutex> lock(resultsMtx_);
+				workerPeaks_[i].takePeaks(tres);
+				taskResults_.emplace(std::move(currentTasks_[i].id), std::move(tres));
+				/* An idle worker is not running any task that could be cancelled */
+				currentTasks_[i] = {};
+			}
+			auto taskTime = std::chrono::steady_clock::now() - start;
+			times.busy += taskTime;
+			updateTaskTime(taskTime);
 
 			/* If that was the last task, notify everyone */
 			std::lock_guard<std::mutex> lock(stateMtx_);
 			if (decRemainingTasks() == 0) {
 				stateCV_.notify_all();
+				doneCV_.notify_all();
 				break;
 			}
 		}
@@ -46,47 +79,260 @@ void ThreadPool::addWorker(unsigned int i, std::unique_ptr<GenMCDriver> driver,
 
 	results_.push_back(std::move(thread.get_future()));
 
-	workers_.emplace_back(std::move(thread), i, std::move(driver), std::move(EE),
+	interpreters_.push_back(std::move(EE));
+	drivers_.push_back(std::move(driver));
+	workers_.emplace_back(std::move(thread), i, &*drivers_.back(), &*interpreters_.back(),
 			      std::move(threadFun));
 	pinner_.pin(workers_.back(), i);
 }
 
-void ThreadPool::submit(ThreadPool::TaskT t)
+void ThreadPool::updateTaskTime(std::chrono::steady_clock::duration d)
+{
+	/* Exponential moving average with a weight of 1/8 for the new sample */
+	auto sample = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+	auto avg = avgTaskNanos_.load(std::memory_order_relaxed);
+	auto navg = avg == 0 ? sample : avg - avg / 8 + sample / 8;
+	while (!avgTaskNanos_.compare_exchange_weak(avg, navg, std::memory_order_relaxed))
+		navg = avg == 0 ? sample : avg - avg / 8 + sample / 8;
+}
+
+auto ThreadPool::shouldSubmit(unsigned int graphSize) const -> bool
+{
+	if (policy_ == ParallelPolicy::Static)
+		return remainingTasks_.load() < 8 * size();
+
+	/* All revisits of shallow tasks are submitted */
+	if (policy_ == ParallelPolicy::Deterministic)
+		return isShallowTask();
+
+	/* Always feed workers that are starving */
+	auto idle = idleWorkers_.load();
+	auto queued = queuedTasks_.load();
+	if (queued < idle)
+		return true;
+
+	/* Otherwise, keep a reserve of queued tasks. Short tasks are consumed
+	 * quickly and need a deeper reserve; long tasks and large graphs (which
+	 * take up memory while queued) need a shallower one */
+	static constexpr std::uint64_t refTaskNanos = 1000000;
+	static constexpr unsigned int refGraphSize = 1024;
+
+	auto avg = std::max<std::uint64_t>(avgTaskNanos_.load(std::memory_order_relaxed), 1);
+	auto reserve = std::clamp<std::uint64_t>(size() * refTaskNanos / avg, 1, 8 * size());
+	reserve = std::max<std::uint64_t>(
+		1, reserve * refGraphSize / std::max(graphSize, refGraphSize));
+	return queued < idle + reserve;
+}
+
+void ThreadPool::notifyIdleWorker()
 {
+	/* Pairs with the increment of idleWorkers_ in popTask(): either the
+	 * idle worker sees the new task, or we see the idle worker */
+	if (idleWorkers_.load() == 0)
+		return;
+
 	std::lock_guard<std::mutex> lock(stateMtx_);
-	incRemainingTasks();
-	queue_.push(std::move(t));
 	stateCV_.notify_one();
 }
 
-auto ThreadPool::tryPopPoolQueue() -> ThreadPool::TaskT { return queue_.tryPop(); }
+void ThreadPool::enqueue(ThreadPool::TaskT t, bool local)
+{
+	incRemainingTasks();
+	++queuedTasks_;
+	++submitted_;
+	if (policy_ == ParallelPolicy::Deterministic && isWorker()) {
+		auto &cur = currentTasks_[getIndex()];
+		t->taskId = cur.id;
+		t->taskId.push_back(cur.children++);
+	}
+	if (trackMemory_ && !t->spilled) {
+		t->queuedBytes = t->getGraph().getMemoryUsage();
+		queuedBytes_ += t->queuedBytes;
+	}
+	if (local)
+		localQueues_[getIndex()]->push(std::move(t));
+	else
+		nodeQueues_[getNode()]->push(std::move(t));
+	notifyIdleWorker();
+}
+
+auto ThreadPool::tryClaimWorkRequest() -> bool
+{
+	/* Donating depending on idle workers would make task IDs depend on
+	 * timing. Instead, shallow tasks donate whenever they can, so that
+	 * the alternatives they would explore locally are split up too */
+	if (policy_ == ParallelPolicy::Deterministic) {
+		if (!isWorker() || !isShallowTask())
+			return false;
+		++claimedRequests_;
+		return true;
+	}
+
+	/* A worker's request is answered by whichever task gets queued
+	 * first; it does not matter which worker ends up popping it */
+	auto claimed = claimedRequests_.load();
+	while (idleWorkers_.load() > queuedTasks_.load() + claimed) {
+		if (claimedRequests_.compare_exchange_weak(claimed, claimed + 1))
+			return true;
+	}
+	return false;
+}
+
+auto ThreadPool::tryPopLocalQueue() -> ThreadPool::TaskT
+{
+	if (!isWorker())
+		return nullptr;
+
+	auto t = localQueues_[getIndex()]->tryPop();
+	if (t)
+		--queuedTasks_;
+	return t;
+}
+
+auto ThreadPool::tryPopNodeQueue(bool remote) -> ThreadPool::TaskT
+{
+	/* Our own queue is at offset 0; the other nodes' queues follow */
+	auto node = getNode();
+	auto n = nodeQueues_.size();
+	auto [first, last] = remote ? std::pair(1UL, n) : std::pair(0UL, 1UL);
+	for (auto i = first; i < last; i++) {
+		auto t = nodeQueues_[(node + i) % n]->tryPop();
+		if (!t)
+			continue;
+
+		--queuedTasks_;
+		if (remote)
+			++stolenRemote_;
+		return t;
+	}
+	return nullptr;
+}
 
-auto ThreadPool::tryStealOtherQueue() -> ThreadPool::TaskT
+auto ThreadPool::tryStealOtherQueue(bool remote) -> ThreadPool::TaskT
 {
-	/* TODO: Implement work-stealing */
+	static thread_local std::minstd_rand rng(std::random_device{}());
+
+	/* Start from a random victim and sweep over the other queues of
+	 * the local (or the remote) NUMA nodes */
+	auto n = localQueues_.size();
+	auto start = std::uniform_int_distribution<std::size_t>(0, n - 1)(rng);
+	for (auto i = 0U; i < n; i++) {
+		auto victim = (start + i) % n;
+		if ((isWorker() && victim == getIndex()) || isRemote(victim) != remote)
+			continue;
+		auto t = localQueues_[victim]->trySteal();
+		if (!t)
+			continue;
+
+		--queuedTasks_;
+		++stolen_;
+		/* The graph is not copied over to our node: that would be an
+		 * extra copy of the whole graph. Each revisit we explore copies
+		 * the graph anyway, and these copies are allocated (first-touch)
+		 * on our node */
+		if (remote)
+			++stolenRemote_;
+		return t;
+	}
 	return nullptr;
 }
 
 auto ThreadPool::popTask() -> ThreadPool::TaskT
 {
 	while (true) {
-		if (auto t = tryPopPoolQueue())
-			return t;
-		if (auto t = tryStealOtherQueue())
+		/* Prefer the tasks of our own NUMA node; with a single
+		 * node, there is nothing remote to look at */
+		auto t = tryPopLocalQueue();
+		for (auto remote : {false, true}) {
+			if (t || (remote && nodeQueues_.size() == 1))
+				break;
+			t = tryPopNodeQueue(remote);
+			if (!t)
+				t = tryStealOtherQueue(remote);
+		}
+		if (t) {
+			queuedBytes_ -= t->queuedBytes;
 			return t;
+		}
 
+		/* Ask busy workers to donate some of their work while we wait */
 		std::unique_lock<std::mutex> lock(stateMtx_);
-		if (shouldHalt() || getRemainingTasks() == 0)
+		++idleWorkers_;
+		/* Only a pool-wide halt applies here: in deterministic mode,
+		 * queued tasks preceding an erroneous one still have to run */
+		stateCV_.wait(lock, [this] {
+			return shouldHalt_.load() || getRemainingTasks() == 0 ||
+			       queuedTasks_.load() > 0;
+		});
+		--idleWorkers_;
+		if (shouldHalt_.load() || getRemainingTasks() == 0)
 			return nullptr;
-		stateCV_.wait(lock);
 	}
 	return nullptr;
 }
 
-auto ThreadPool::waitForTasks() -> std::vector<std::future<VerificationResult>>
+void ThreadPool::halt()
 {
-	while (!shouldHalt() && getRemainingTasks() > 0)
-		std::this_thread::yield();
+	/* Tasks that come before the erroneous one need to complete,
+	 * as they might contain errors too */
+	if (policy_ == ParallelPolicy::Deterministic && isWorker()) {
+		std::lock_guard<std::mutex> lock(resultsMtx_);
+		const auto &id = currentTasks_[getIndex()].id;
+		if (!errorTaskId_ || id < *errorTaskId_)
+			errorTaskId_ = id;
+		errorFound_.store(true);
+		return;
+	}
 
+	std::lock_guard<std::mutex> lock(stateMtx_);
+	shouldHalt_.store(true);
+	stateCV_.notify_all();
+	doneCV_.notify_all();
+}
+
+auto ThreadPool::isCurrentTaskCancelled() const -> bool
+{
+	if (!isWorker())
+		return false;
+
+	std::lock_guard<std::mutex> lock(resultsMtx_);
+	return errorTaskId_ && currentTasks_[getIndex()].id > *errorTaskId_;
+}
+
+auto ThreadPool::waitForTasks() -> std::vector<std::future<VerificationResult>>
+{
+	/* Workers notify us when the last task completes (or on halt).
+	 * We do not wait on stateCV_, so that the wakeups meant for idle
+	 * workers (see notifyIdleWorker()) are not consumed by us */
+	std::unique_lock<std::mutex> lock(stateMtx_);
+	doneCV_.wait(lock, [this] { return shouldHalt() || getRemainingTasks() == 0; });
 	return std::move(results_);
 }
+
+auto ThreadPool::reduceTaskResults() -> VerificationResult
+{
+	std::lock_guard<std::mutex> lock(resultsMtx_);
+
+	VerificationResult res;
+	for (auto &[id, tres] : taskResults_) {
+		if (errorTaskId_ && id > *errorTaskId_)
+			break;
+
+		/* Every task reports the warnings it encounters; only keep
+		 * the messages of tasks that report something new */
+		if (tres.status == VerificationError::VE_OK &&
+		    std::ranges::all_of(tres.warnings,
+					[&](auto &w) { return res.warnings.count(w) != 0; }))
+			tres.message.clear();
+		res += std::move(tres);
+	}
+	taskResults_.clear();
+
+	/* Tasks of the same worker ran one after the other, while
+	 * different workers ran concurrently, so their peaks add up */
+	for (auto &peaks : workerPeaks_)
+		res += std::move(peaks);
+	workerPeaks_.clear();
+	workerPeaks_.resize(numWorkers_);
+	return res;
+}
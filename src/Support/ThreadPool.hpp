@@ -17,15 +17,22 @@
 #include "ExecutionGraph/DepExecutionGraph.hpp"
 #include "Runtime/Interpreter.h"
 #include "Static/LLVMModule.hpp"
+#include "Support/Error.hpp"
 #include "Support/ThreadPinner.hpp"
+#include "Support/WorkPool.hpp"
 #include "Verification/GenMCDriver.hpp"
+#include "Verification/SharedLabelCache.hpp"
 #include "Verification/VerificationResult.hpp"
 #include <llvm/IR/Module.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <future>
+#include <map>
 #include <memory>
+#include <optional>
 #include <thread>
 
 /*******************************************************************************
@@ -85,6 +92,163 @@ private:
 	std::mutex qMutex;
 };
 
+/*******************************************************************************
+ **                           LocalWorkQueue Class
+ ******************************************************************************/
+
+/**
+ * Represents the work queue of a single worker. This is a Chase-Lev deque:
+ * the owner pushes and pops items at the bottom without taking a lock, while
+ * other workers steal items from the top. The implementation follows the
+ * C11 formalization of Le et al. (PPoPP'13).
+ */
+class LocalWorkQueue {
+
+public:
+	using ItemT = std::unique_ptr<GenMCDriver::Execution>;
+
+	/*** Constructors ***/
+
+	explicit LocalWorkQueue(std::size_t capacity = 64)
+	{
+		BUG_ON(capacity == 0 || (capacity & (capacity - 1)) != 0);
+		buffers_.push_back(std::make_unique<Buffer>(capacity));
+		buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+	}
+	LocalWorkQueue(const LocalWorkQueue &) = delete;
+	LocalWorkQueue(LocalWorkQueue &&) = delete;
+
+	auto operator=(const LocalWorkQueue &) -> LocalWorkQueue & = delete;
+	auto operator=(LocalWorkQueue &&) -> LocalWorkQueue & = delete;
+
+	/** Frees any items left in the queue (e.g., if the pool was halted) */
+	~LocalWorkQueue()
+	{
+		auto *buf = buffer_.load(std::memory_order_relaxed);
+		for (auto i = top_.load(std::memory_order_relaxed);
+		     i < bottom_.load(std::memory_order_relaxed); i++)
+			delete buf->get(i);
+	}
+
+	/*** Queue operations ***/
+
+	/** Returns an approximation of the number of items in the queue */
+	[[nodiscard]] auto size() const -> std::size_t
+	{
+		auto b = bottom_.load(std::memory_order_relaxed);
+		auto t = top_.load(std::memory_order_relaxed);
+		return b > t ? b - t : 0;
+	}
+
+	/** Returns true if the queue (seems to be) empty */
+	[[nodiscard]] auto empty() const -> bool { return size() == 0; }
+
+	/** Adds a new item at the bottom of the queue (owner only) */
+	void push(ItemT item)
+	{
+		auto b = bottom_.load(std::memory_order_relaxed);
+		auto t = top_.load(std::memory_order_acquire);
+		auto *buf = buffer_.load(std::memory_order_relaxed);
+		if (b - t > static_cast<std::int64_t>(buf->capacity()) - 1)
+			buf = grow(buf, t, b);
+		buf->put(b, item.release());
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom_.store(b + 1, std::memory_order_relaxed);
+	}
+
+	/** Tries to pop the most recently pushed item (owner only) */
+	auto tryPop() -> ItemT
+	{
+		auto b = bottom_.load(std::memory_order_relaxed) - 1;
+		auto *buf = buffer_.load(std::memory_order_relaxed);
+		bottom_.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto t = top_.load(std::memory_order_relaxed);
+
+		if (t > b) {
+			bottom_.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		auto *item = buf->get(b);
+		if (t == b) {
+			/* Last item: race against thieves */
+			if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+							  std::memory_order_relaxed))
+				item = nullptr;
+			bottom_.store(b + 1, std::memory_order_relaxed);
+		}
+		return ItemT(item);
+	}
+
+	/** Tries to steal the oldest item of the queue (any thread).
+	 * May spuriously fail when racing with other thieves or the owner */
+	auto trySteal() -> ItemT
+	{
+		auto t = top_.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto b = bottom_.load(std::memory_order_acquire);
+		if (t >= b)
+			return nullptr;
+
+		auto *item = buffer_.load(std::memory_order_acquire)->get(t);
+		if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+						  std::memory_order_relaxed))
+			return nullptr;
+		return ItemT(item);
+	}
+
+private:
+	using RawT = GenMCDriver::Execution *;
+
+	/** A circular array of (raw) items; its capacity is a power of 2 */
+	class Buffer {
+	public:
+		explicit Buffer(std::size_t capacity)
+			: mask_(capacity - 1), slots_(std::make_unique<std::atomic<RawT>[]>(capacity))
+		{}
+
+		[[nodiscard]] auto capacity() const -> std::size_t { return mask_ + 1; }
+
+		[[nodiscard]] auto get(std::int64_t i) const -> RawT
+		{
+			return slots_[i & mask_].load(std::memory_order_relaxed);
+		}
+
+		void put(std::int64_t i, RawT item)
+		{
+			slots_[i & mask_].store(item, std::memory_order_relaxed);
+		}
+
+	private:
+		std::size_t mask_;
+		std::unique_ptr<std::atomic<RawT>[]> slots_;
+	};
+
+	/** Doubles the capacity of BUF (owner only). The old buffer is kept
+	 * around until destruction, as thieves might still be reading from it */
+	auto grow(Buffer *buf, std::int64_t t, std::int64_t b) -> Buffer *
+	{
+		buffers_.push_back(std::make_unique<Buffer>(2 * buf->capacity()));
+		auto *nbuf = buffers_.back().get();
+		for (auto i = t; i < b; i++)
+			nbuf->put(i, buf->get(i));
+		buffer_.store(nbuf, std::memory_order_release);
+		return nbuf;
+	}
+
+	/** Indices of the oldest item and the next free slot, respectively
+	 * (on different cache lines to avoid false sharing) */
+	alignas(64) std::atomic<std::int64_t> top_{0};
+	alignas(64) std::atomic<std::int64_t> bottom_{0};
+
+	/** The buffer currently in use */
+	std::atomic<Buffer *> buffer_{nullptr};
+
+	/** All buffers ever allocated (only accessed by the owner) */
+	std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
 /*******************************************************************************
  **                           ThreadJoiner Class
  ******************************************************************************/
@@ -125,12 +289,16 @@ private:
  * submitted dynamically to the threads for execution. Each thread will have
  * each own exploration driver so that they will able to execute the submitted
  * (exploration) tasks concurrently.
+ *
+ * Tasks submitted by a worker are pushed to the worker's local queue; idle
+ * workers steal from the local queues of random victims. Tasks submitted by
+ * non-worker threads go to a global queue.
  */
-class ThreadPool {
+class ThreadPool : public WorkPool {
 
 public:
 	using GlobalQueueT = GlobalWorkQueue;
-	using TaskT = GlobalQueueT::ItemT;
+	using LocalQueueT = LocalWorkQueue;
 	using TFunT = void (*)(GenMCDriver *, llvm::Interpreter *);
 
 	/*** Constructors ***/
@@ -141,12 +309,30 @@ public:
 	ThreadPool(const std::shared_ptr<const Config> &conf,
 		   const std::unique_ptr<llvm::Module> &mod, const std::unique_ptr<ModuleInfo> &MI,
 		   TFunT threadFun)
-		: numWorkers_(conf->threads), pinner_(numWorkers_), joiner_(workers_)
+		: numWorkers_(conf->threads), policy_(conf->parallelPolicy),
+		  splitDepth_(conf->deterministicSplitDepth.value_or(calcSplitDepth(numWorkers_))),
+		  trackMemory_(conf->memoryLimit || conf->printMemoryStats), pinner_(numWorkers_),
+		  joiner_(workers_)
 	{
 
 		/* Set global variables before spawning the threads */
 		shouldHalt_.store(false);
 		remainingTasks_.store(0);
+		queuedTasks_.store(0);
+		idleWorkers_.store(0);
+		claimedRequests_.store(0);
+		avgTaskNanos_.store(0);
+
+		/* Every NUMA node and every worker gets its own queue */
+		for (auto i = 0U; i < pinner_.getNumNodes(); i++)
+			nodeQueues_.push_back(std::make_unique<GlobalQueueT>());
+		for (auto i = 0U; i < numWorkers_; i++) {
+			localQueues_.push_back(std::make_unique<LocalQueueT>());
+			workerNodes_.push_back(pinner_.getNode(i));
+		}
+		workerTimes_.resize(numWorkers_);
+		currentTasks_.resize(numWorkers_);
+		workerPeaks_.resize(numWorkers_);
 
 		/* Have a non-empty queue before spawning workers */
 		auto dummyGetter = [](auto &addr) { return SVal(0); };
@@ -170,6 +356,8 @@ public:
 							    &*dw, dw->getConf(),
 							    dw->getExec().getAllocator(), &buf);
 			dw->setEE(&*EE);
+			if (conf->instructionCaching)
+				dw->getScheduler().setSharedCache(&labelCache_);
 			addWorker(i, std::move(dw), std::move(EE), threadFun);
 		}
 	}
@@ -192,49 +380,178 @@ public:
 	/** Sets the index of the calling thread */
 	void setIndex(unsigned int i) { index_ = i; }
 
+	/** Returns true if the calling thread is a worker of the pool */
+	[[nodiscard]] auto isWorker() const -> bool { return index_ < localQueues_.size(); }
+
 	/*** Tasks-related ***/
 
+	/** Time a worker spent executing tasks and waiting for tasks */
+	struct WorkerTimes {
+		std::chrono::steady_clock::duration busy{};
+		std::chrono::steady_clock::duration idle{};
+	};
+
+	/** Statistics about the tasks handled by the pool */
+	struct Stats {
+		unsigned submitted{};		  /**< Number of tasks submitted */
+		unsigned donated{};		  /**< Number of tasks donated to idle workers */
+		unsigned stolen{};		  /**< Number of tasks stolen from other workers */
+		unsigned stolenRemote{};	  /**< Number of tasks stolen across NUMA nodes */
+		std::vector<WorkerTimes> workers; /**< Busy/idle times of each worker */
+		std::size_t cacheBytes{};	  /**< Bytes held by the shared instruction cache */
+		std::size_t cacheEntries{};	  /**< Sequences in the shared instruction cache */
+	};
+
+	/** Returns statistics about the tasks handled so far.
+	 * Worker times are only accurate once all results are available */
+	[[nodiscard]] auto getStats() const -> Stats
+	{
+		return {submitted_.load(),
+			donated_.load(),
+			stolen_.load(),
+			stolenRemote_.load(),
+			workerTimes_,
+			labelCache_.getMemoryUsage(),
+			labelCache_.getNumEntries()};
+	}
+
+	/** Returns whether a new task for a graph of size GRAPHSIZE should be
+	 * submitted to the pool (instead of being explored locally) */
+	[[nodiscard]] auto shouldSubmit(unsigned int graphSize) const -> bool override;
+
 	/** Submits a task to be executed by a worker */
-	void submit(TaskT task);
+	void submit(TaskT task) override { enqueue(std::move(task), isWorker()); }
+
+	/** Submits a task as an answer to a work request */
+	void donate(TaskT task) override
+	{
+		++donated_;
+		enqueue(std::move(task), false);
+		--claimedRequests_;
+	}
 
 	/** Notify the pool about the addition/completion of a task */
 	auto incRemainingTasks() -> unsigned { return ++remainingTasks_; }
 	auto decRemainingTasks() -> unsigned { return --remainingTasks_; }
 	auto getRemainingTasks() -> unsigned { return remainingTasks_.load(); }
 
-	[[nodiscard]] auto shouldHalt() const -> bool { return shouldHalt_.load(); }
+	[[nodiscard]] auto shouldHalt() const -> bool override
+	{
+		return shouldHalt_.load() || (errorFound_.load() && isCurrentTaskCancelled());
+	}
+
+	/** Claims a pending request of an idle worker for more work.
+	 * Returns true if the caller should donate some of its work */
+	auto tryClaimWorkRequest() -> bool override;
 
-	/** Stops all threads */
-	void halt()
+	/** Returns a claimed request (e.g., if there was nothing to donate) */
+	void unclaimWorkRequest() override { --claimedRequests_; }
+
+	/** Stops all threads. Under the deterministic policy, a worker only
+	 * stops the tasks that come after its current one */
+	void halt() override;
+
+	/** Returns an estimate of the bytes held by queued tasks and the
+	 * shared instruction cache (only tracked if memory usage is) */
+	[[nodiscard]] auto getMemoryUsage() const -> std::size_t override
 	{
-		std::lock_guard<std::mutex> lock(stateMtx_);
-		shouldHalt_.store(true);
-		stateCV_.notify_all();
+		return queuedBytes_.load() + labelCache_.getMemoryUsage();
 	}
 
-	/** Waits for all tasks to complete */
+	/** Freezes the shared instruction cache. (Queued tasks cannot be
+	 * dropped, and submitting more only moves them into a queue) */
+	void limitMemoryUsage() override { labelCache_.freeze(); }
+
+	[[nodiscard]] auto isDistributed() const -> bool override { return false; }
+
+	/** Blocks until all tasks have completed (or the pool is halted) */
 	auto waitForTasks() -> std::vector<std::future<VerificationResult>>;
 
+	/** Deterministic policy: Combines the results of the tasks in task-ID
+	 * order, up to the first task that found an error. (The results
+	 * returned by the workers are then empty.) */
+	auto reduceTaskResults() -> VerificationResult;
+
 	/*** Destructor ***/
 
-	~ThreadPool() { halt(); }
+	~ThreadPool() override { halt(); }
 
 private:
 	/** Adds a worker thread to the pool */
 	void addWorker(unsigned int index, std::unique_ptr<GenMCDriver> driver,
 		       std::unique_ptr<llvm::Interpreter> EE, TFunT threadFun);
 
-	/** Tries to pop a task from the global queue */
-	auto tryPopPoolQueue() -> TaskT;
+	/** Wakes up an idle worker (if any) */
+	void notifyIdleWorker();
+
+	/** Accounts for a task that took D to complete */
+	void updateTaskTime(std::chrono::steady_clock::duration d);
 
-	/** Tries to steal a task from another thread */
-	auto tryStealOtherQueue() -> TaskT;
+	/** Deterministic policy: Whether the task of the calling worker comes
+	 * after a task that found an error */
+	[[nodiscard]] auto isCurrentTaskCancelled() const -> bool;
+
+	/** Deterministic policy: Whether the task of the calling worker is
+	 * shallow enough to be split into more tasks. This only depends on
+	 * the task itself, so task IDs are reproducible */
+	[[nodiscard]] auto isShallowTask() const -> bool
+	{
+		return currentTasks_[getIndex()].id.size() < splitDepth_;
+	}
+
+	/** Deterministic policy: The default split depth for N workers. If
+	 * every split level (at least) doubles the number of tasks, the tasks
+	 * at this depth outnumber the workers by a factor of 4 or more */
+	static auto calcSplitDepth(unsigned int n) -> unsigned int
+	{
+		auto depth = 2U;
+		for (auto tasks = 1U; tasks < n; tasks *= 2)
+			++depth;
+		return depth;
+	}
+
+	/** Tries to pop a task from the local queue of the calling thread */
+	auto tryPopLocalQueue() -> TaskT;
+
+	/** Adds a task to the queue of the calling worker (LOCAL), or to the
+	 * queue of its NUMA node, where any idle worker of the node can pick
+	 * it up (e.g., tasks of non-workers, and donations) */
+	void enqueue(TaskT t, bool local);
+
+	/** Tries to pop a task from the queue of the calling thread's NUMA
+	 * node (or, if REMOTE, from the queues of the other nodes) */
+	auto tryPopNodeQueue(bool remote) -> TaskT;
+
+	/** Returns the NUMA node of the calling thread (non-workers use the first one) */
+	[[nodiscard]] auto getNode() const -> unsigned int
+	{
+		return isWorker() ? workerNodes_[getIndex()] : 0;
+	}
+
+	/** Whether worker VICTIM resides on a different NUMA node than the calling thread */
+	[[nodiscard]] auto isRemote(unsigned int victim) const -> bool
+	{
+		return workerNodes_[victim] != getNode();
+	}
+
+	/** Tries to steal a task from another thread on the calling
+	 * thread's NUMA node (or, if REMOTE, on the other nodes) */
+	auto tryStealOtherQueue(bool remote) -> TaskT;
 
 	/** Pops the next task to be executed by a thread */
 	auto popTask() -> TaskT;
 
 	std::vector<std::unique_ptr<llvm::LLVMContext>> contexts_;
 
+	/** The workers' interpreters and drivers. These are kept alive until
+	 * the pool is destroyed, as cached labels may point to any worker's
+	 * module information */
+	std::vector<std::unique_ptr<llvm::Interpreter>> interpreters_;
+	std::vector<std::unique_ptr<GenMCDriver>> drivers_;
+
+	/** Instruction cache shared among all workers */
+	SharedLabelCache labelCache_;
+
 	/** Result of each thread */
 	std::vector<std::future<VerificationResult>> results_;
 
@@ -247,13 +564,73 @@ private:
 	/** The worker threads */
 	std::vector<std::thread> workers_;
 
-	/** A queue where tasks are stored */
-	GlobalQueueT queue_;
+	/** Per-NUMA-node queues where tasks submitted by non-workers
+	 * and donations are stored */
+	std::vector<std::unique_ptr<GlobalQueueT>> nodeQueues_;
+
+	/** Per-worker queues where tasks submitted by workers are stored */
+	std::vector<std::unique_ptr<LocalQueueT>> localQueues_;
+
+	/** The NUMA node each worker is pinned to */
+	std::vector<unsigned int> workerNodes_;
+
+	/** Deterministic policy: The task each worker is exploring. A task's ID
+	 * is its parent's ID extended with the number of tasks the parent
+	 * submitted before it, so it only depends on the parent's exploration */
+	struct CurrentTask {
+		std::vector<unsigned int> id;
+		unsigned int children{}; /**< Tasks submitted so far */
+	};
+	std::vector<CurrentTask> currentTasks_;
+
+	/** Deterministic policy: The results of each task (without their
+	 * peaks, which are kept per worker), and the ID of the first task
+	 * (in ID order) that found an error */
+	std::map<std::vector<unsigned int>, VerificationResult> taskResults_;
+	std::vector<VerificationResult> workerPeaks_; /**< Largest peaks of each worker's tasks */
+	std::optional<std::vector<unsigned int>> errorTaskId_;
+	std::atomic<bool> errorFound_{false};
+	mutable std::mutex resultsMtx_;
 
 	/** Number of tasks that need to be executed across threads */
 	std::atomic<unsigned> remainingTasks_;
 
-	/** The index of a worker thread */
+	/** Number of tasks currently residing in some queue */
+	std::atomic<unsigned> queuedTasks_;
+
+	/** Number of workers waiting for a task */
+	std::atomic<unsigned> idleWorkers_;
+
+	/** Number of work requests that have been claimed but not answered yet.
+	 * Every idle worker for which no task is queued has a pending request,
+	 * so requests do not need to be withdrawn once a worker wakes up */
+	std::atomic<unsigned> claimedRequests_;
+
+	/** The policy used to decide when to submit tasks */
+	ParallelPolicy policy_;
+
+	/** Deterministic policy: Tasks with shorter IDs are split */
+	unsigned int splitDepth_;
+
+	/** Whether the memory held by queued tasks is tracked */
+	bool trackMemory_;
+
+	/** (Estimated) bytes held by queued tasks */
+	std::atomic<std::size_t> queuedBytes_{0};
+
+	/** Moving average of the time a task takes to complete (ns) */
+	std::atomic<std::uint64_t> avgTaskNanos_;
+
+	/** Task statistics */
+	std::atomic<unsigned> submitted_{};
+	std::atomic<unsigned> donated_{};
+	std::atomic<unsigned> stolen_{};
+	std::atomic<unsigned> stolenRemote_{};
+
+	/** Busy/idle times of each worker (only written by the respective worker) */
+	std::vector<WorkerTimes> workerTimes_;
+
+	/** The index of a worker thread (invalid for non-workers) */
 	static thread_local unsigned int index_;
 
 	/** Mutex+CV to determine whether the pool state has changed:
@@ -261,6 +638,10 @@ private:
 	std::mutex stateMtx_;
 	std::condition_variable stateCV_;
 
+	/** Notified (under stateMtx_) when all tasks have been completed,
+	 * or the pool is halted; only waitForTasks() waits on it */
+	std::condition_variable doneCV_;
+
 	ThreadPinner pinner_;
 
 	/** The thread joiner */
@@ -0,0 +1,80 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#ifndef GENMC_WORK_POOL_HPP
+#define GENMC_WORK_POOL_HPP
+
+#include "Verification/GenMCDriver.hpp"
+
+#include <cstddef>
+#include <memory>
+
+/*******************************************************************************
+ **                            WorkPool Class
+ ******************************************************************************/
+
+/**
+ * The interface through which a driver shares work with other drivers.
+ * Implemented by ThreadPool (drivers in the same process) and by
+ * DistributedWorker (drivers in different processes).
+ */
+class WorkPool {
+
+public:
+	using TaskT = std::unique_ptr<GenMCDriver::Execution>;
+
+	WorkPool() = default;
+	WorkPool(const WorkPool &) = delete;
+	WorkPool(WorkPool &&) = delete;
+
+	auto operator=(const WorkPool &) -> WorkPool & = delete;
+	auto operator=(WorkPool &&) -> WorkPool & = delete;
+
+	virtual ~WorkPool() = default;
+
+	/** Returns whether a new task for a graph of size GRAPHSIZE should be
+	 * submitted to the pool (instead of being explored locally) */
+	[[nodiscard]] virtual auto shouldSubmit(unsigned int graphSize) const -> bool = 0;
+
+	/** Submits a task to be executed by some other driver */
+	virtual void submit(TaskT task) = 0;
+
+	/** Submits a task as an answer to a work request */
+	virtual void donate(TaskT task) = 0;
+
+	/** Claims a pending request of an idle driver for more work.
+	 * Returns true if the caller should donate some of its work */
+	virtual auto tryClaimWorkRequest() -> bool = 0;
+
+	/** Returns a claimed request (e.g., if there was nothing to donate) */
+	virtual void unclaimWorkRequest() = 0;
+
+	/** Whether all drivers should stop exploring */
+	[[nodiscard]] virtual auto shouldHalt() const -> bool = 0;
+
+	/** Stops all drivers */
+	virtual void halt() = 0;
+
+	/** Returns an estimate of the bytes the pool holds in this process
+	 * (e.g., queued tasks and shared caches) */
+	[[nodiscard]] virtual auto getMemoryUsage() const -> std::size_t = 0;
+
+	/** Stops the pool's shared caches from growing any further */
+	virtual void limitMemoryUsage() = 0;
+
+	/** Whether submitted tasks are explored by a different process
+	 * (so that submitting them frees memory in this one) */
+	[[nodiscard]] virtual auto isDistributed() const -> bool = 0;
+};
+
+#endif /* GENMC_WORK_POOL_HPP */
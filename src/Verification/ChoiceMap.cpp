@@ -12,6 +12,7 @@
  */
 
 #include "Verification/ChoiceMap.hpp"
+#include "Support/Serialization.hpp"
 
 #include <algorithm>
 
@@ -56,3 +57,25 @@ void ChoiceMap::cut(const VectorClock &v)
 		++it;
 	}
 }
+
+void ChoiceMap::serialize(ByteWriter &out) const
+{
+	out.writeU64(cmap_.size());
+	for (const auto &[e, choices] : cmap_) {
+		e.serialize(out);
+		out.writeU64(choices.size());
+		for (const auto &c : choices)
+			c.serialize(out);
+	}
+}
+
+auto ChoiceMap::deserialize(ByteReader &in) -> ChoiceMap
+{
+	ChoiceMap result;
+	for (auto n = in.readU64(); n > 0; n--) {
+		auto &choices = result.cmap_[Event::deserialize(in)];
+		for (auto m = in.readU64(); m > 0; m--)
+			choices.insert(Event::deserialize(in));
+	}
+	return result;
+}
@@ -47,6 +47,10 @@ public:
 
 	void cut(const VectorClock &v);
 
+	/** Serialization facilities (see Support/Serialization.hpp) */
+	void serialize(ByteWriter &out) const;
+	static auto deserialize(ByteReader &in) -> ChoiceMap;
+
 private:
 	std::unordered_map<Event, VSet<Event>> cmap_;
 };
@@ -28,25 +28,29 @@
 #include "Support/Logger.hpp"
 #include "Support/Parser.hpp"
 #include "Support/SExprVisitor.hpp"
-#include "Support/ThreadPool.hpp"
+#include "Support/Serialization.hpp"
+#include "Support/WorkPool.hpp"
 #include "Verification/DriverHandlerDispatcher.hpp"
 #include "Verification/Relinche/LinearizabilityChecker.hpp"
 #include "Verification/Scheduler.hpp"
 #include "Verification/VerificationResult.hpp"
+#include <llvm/ADT/SmallString.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/Support/DynamicLibrary.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Format.h>
 #include <llvm/Support/raw_os_ostream.h>
 
 #include <algorithm>
 #include <csignal>
+#include <numeric>
 #include <span>
 
 /************************************************************
  ** GENERIC MODEL CHECKING DRIVER
  ***********************************************************/
 
-GenMCDriver::GenMCDriver(std::shared_ptr<const Config> conf, ThreadPool *pool /* = nullptr */,
+GenMCDriver::GenMCDriver(std::shared_ptr<const Config> conf, WorkPool *pool /* = nullptr */,
 			 Mode mode /* = VerificationMode{} */)
 	: mode(mode), pool(pool), userConf(std::move(conf))
 {
@@ -155,21 +159,97 @@ void GenMCDriver::Execution::restrict(Stamp stamp)
 	getAllocator().restrict(createAllocView(g));
 }
 
-void GenMCDriver::pushExecution(Execution &&e) { execStack.push_back(std::move(e)); }
+void GenMCDriver::Execution::serialize(ByteWriter &out) const
+{
+	getGraph().serialize(out);
+	getWorkqueue().serialize(out);
+	getChoiceMap().serialize(out);
+	getAllocator().serialize(out);
+	getLastAdded().serialize(out);
+}
+
+auto GenMCDriver::Execution::deserialize(ByteReader &in, ExecutionGraph::InitValGetter f)
+	-> std::unique_ptr<Execution>
+{
+	auto g = ExecutionGraph::deserialize(in, std::move(f));
+	auto w = WorkList::deserialize(in);
+	auto cm = ChoiceMap::deserialize(in);
+	auto alloctor = SAddrAllocator::deserialize(in);
+	auto lastAdded = Event::deserialize(in);
+	return std::make_unique<Execution>(std::move(g), std::move(w), std::move(cm),
+					   std::move(alloctor), lastAdded);
+}
+
+void GenMCDriver::pushExecution(Execution &&e)
+{
+	/* Spilling is deferred (see spillDeepExecutions()), as the new
+	 * entry might be handed to the pool right away */
+	execStack.push_back(std::move(e));
+}
+
+void GenMCDriver::spillDeepExecutions()
+{
+	/* Only keep the top entries of the stack in memory */
+	auto resident = getConf()->spillExecStack;
+	if (!resident || execStack.size() <= *resident)
+		return;
+
+	/* Spilled entries form a prefix of the stack; extend it bottom-up */
+	auto end = execStack.size() - *resident;
+	auto begin = end;
+	while (begin > 0 && !execStack[begin - 1].spilled)
+		--begin;
+	for (auto i = begin; i < end; i++)
+		spillExecution(execStack[i]);
+}
 
 bool GenMCDriver::popExecution()
 {
 	if (execStack.empty())
 		return false;
 	execStack.pop_back();
+	if (!execStack.empty() && getExec().spilled)
+		reloadExecution(getExec());
 	return !execStack.empty();
 }
 
+void GenMCDriver::spillExecution(Execution &exec)
+{
+	ByteWriter out;
+	exec.getGraph().serialize(out);
+	exec.getChoiceMap().serialize(out);
+	exec.getAllocator().serialize(out);
+	exec.spilled = spillFile.write(out.data());
+
+	exec.graph = nullptr;
+	exec.choices = ChoiceMap();
+	exec.alloctor = SAddrAllocator();
+}
+
+void GenMCDriver::reloadExecution(Execution &exec, bool release /* = true */)
+{
+	auto data = spillFile.read(*exec.spilled);
+	if (release) {
+		spillFile.drop(*exec.spilled);
+		exec.spilled.reset();
+	}
+
+	ByteReader in(data);
+	exec.graph = ExecutionGraph::deserialize(
+		in, [this](const auto &access) { return getEE()->getLocInitVal(access); });
+	exec.choices = ChoiceMap::deserialize(in);
+	exec.alloctor = SAddrAllocator::deserialize(in);
+}
+
 void GenMCDriver::initFromState(std::unique_ptr<Execution> exec)
 {
+	/* An error in a previous task does not concern this one */
+	shouldHalt = false;
 	execStack.clear();
-	execStack.emplace_back(std::move(exec->graph), LocalQueueT(), std::move(exec->choices),
-			       std::move(exec->alloctor), exec->lastAdded);
+	spillFile.clear();
+	execStack.emplace_back(std::move(exec->graph), std::move(exec->workqueue),
+			       std::move(exec->choices), std::move(exec->alloctor),
+			       exec->lastAdded);
 
 	/* We have to also reset the initvalgetter */
 	getExec().getGraph().setInitValGetter(
@@ -178,9 +258,118 @@ void GenMCDriver::initFromState(std::unique_ptr<Execution> exec)
 
 std::unique_ptr<GenMCDriver::Execution> GenMCDriver::extractState()
 {
-	return std::make_unique<Execution>(GenMCDriver::Execution(
-		getExec().getGraph().clone(), LocalQueueT(), ChoiceMap(getExec().getChoiceMap()),
-		SAddrAllocator(getExec().getAllocator()), getExec().getLastAdded()));
+	BUG_ON(execStack.size() < 2);
+	auto state = std::make_unique<Execution>(std::move(execStack.back()));
+	execStack.pop_back();
+	if (getExec().spilled)
+		reloadExecution(getExec());
+	return state;
+}
+
+bool GenMCDriver::donateOldestRevisit()
+{
+	/* Only donate if we will still have some work left afterwards */
+	auto pending = std::accumulate(execStack.begin(), execStack.end(), 0UL,
+				       [](auto sum, auto &exec) {
+					       return sum + exec.getWorkqueue().size();
+				       });
+	if (pending < 2)
+		return false;
+
+	/* The oldest revisits reside at the bottom of the stack */
+	auto execIt = std::ranges::find_if(
+		execStack, [](auto &exec) { return !exec.getWorkqueue().empty(); });
+	BUG_ON(execIt == execStack.end());
+
+	/* Spilled entries are read back temporarily (they are copied anyway) */
+	if (execIt->spilled) {
+		reloadExecution(*execIt, false);
+		WorkList wlist;
+		wlist.add(execIt->getWorkqueue().getOldest());
+		getWorkPool()->donate(std::make_unique<Execution>(GenMCDriver::Execution(
+			std::move(execIt->graph), std::move(wlist), std::move(execIt->choices),
+			std::move(execIt->alloctor), execIt->getLastAdded())));
+		execIt->choices = ChoiceMap();
+		execIt->alloctor = SAddrAllocator();
+		return true;
+	}
+
+	WorkList wlist;
+	wlist.add(execIt->getWorkqueue().getOldest());
+	getWorkPool()->donate(std::make_unique<Execution>(GenMCDriver::Execution(
+		execIt->getGraph().clone(), std::move(wlist), ChoiceMap(execIt->getChoiceMap()),
+		SAddrAllocator(execIt->getAllocator()), execIt->getLastAdded())));
+	return true;
+}
+
+void GenMCDriver::trackMemoryUsage()
+{
+	/* Only sample every so often, as this visits all the graphs in the stack */
+	static constexpr unsigned int sampleInterval = 64;
+
+	const auto *conf = getConf();
+	if ((!conf->memoryLimit && !conf->printMemoryStats) || inEstimationMode() ||
+	    ++memoryTrackingCalls % sampleInterval != 0)
+		return;
+
+	/* Only the graphs of entries that have not been spilled count */
+	auto residentGraphs = [&] {
+		return std::accumulate(execStack.begin(), execStack.end(), 0UL,
+				       [](auto sum, auto &exec) {
+					       return exec.spilled
+							      ? sum
+							      : sum + exec.getGraph().getMemoryUsage();
+				       });
+	};
+	auto graphs = residentGraphs();
+	auto cache = getScheduler().getCacheMemoryUsage();
+	auto spec = result.specification ? result.specification->getMemoryUsage() : 0UL;
+
+	/* Queued tasks and shared caches are charged to all threads of the pool */
+	auto *tp = getWorkPool();
+	auto pool = tp ? tp->getMemoryUsage() / std::max(1U, conf->threads) : 0UL;
+	result.peakGraphMemory = std::max(result.peakGraphMemory, graphs);
+	result.peakCacheMemory = std::max(result.peakCacheMemory, cache);
+	result.peakSpecMemory = std::max(result.peakSpecMemory, spec);
+	result.peakPoolMemory = std::max(result.peakPoolMemory, pool);
+	result.peakStackDepth = std::max<unsigned>(result.peakStackDepth, execStack.size());
+
+	/* The limit is split evenly among the threads of the pool */
+	if (!conf->memoryLimit)
+		return;
+	auto limit = (std::size_t(*conf->memoryLimit) << 20U) / std::max(1U, conf->threads);
+	if (graphs + cache + spec + pool <= limit)
+		return;
+
+	++result.memoryMitigations;
+
+	/* First, drop the instruction cache (it is rebuilt on demand),
+	 * and stop the one shared with other threads from growing */
+	getScheduler().clearCache();
+	if (tp)
+		tp->limitMemoryUsage();
+	if (graphs + spec + pool <= limit)
+		return;
+
+	/* Then, hand the pending revisits off to other processes (the graphs
+	 * of the stack have already been explored, so finished ones are dropped).
+	 * Submitting to a thread pool would only move the graphs into its queues.
+	 * The total is recomputed each time, as removing the top entry might
+	 * read back a spilled one */
+	if (tp && tp->isDistributed()) {
+		while (execStack.size() >= 2 && graphs + spec + pool > limit) {
+			if (getExec().getWorkqueue().empty())
+				popExecution();
+			else
+				tp->submit(extractState());
+			graphs = residentGraphs();
+		}
+	}
+	if (graphs + spec + pool > limit) {
+		LOG_ONCE("memory-limit", VerbosityLevel::Warning)
+			<< "Exploration memory usage exceeds the limit set with -memory-limit. "
+			<< "Consider using more threads or bounding the exploration\n";
+	}
 }
 
 /* Returns a fresh address to be used from the interpreter */
@@ -272,6 +461,36 @@ void GenMCDriver::trackExecutionBound()
 	result.exploredBounds.grow(bound);
 	result.exploredBounds[bound]++;
 }
+
+void GenMCDriver::checkGraphSerialization()
+{
+	llvm::SmallString<128> path;
+	auto err = llvm::sys::fs::createTemporaryFile("genmc-graph", "bin", path);
+	ERROR_ON(err, "Could not create graph file: " << err.message() << "\n");
+
+	auto &g = getExec().getGraph();
+	auto saved = g.save(std::string(path));
+	auto loaded = saved ? ExecutionGraph::load(std::string(path),
+						   [this](const auto &access) {
+							   return getEE()->getLocInitVal(access);
+						   })
+			    : nullptr;
+	llvm::sys::fs::remove(path);
+	ERROR_ON(!loaded, "Could not save or load graph file: " << path << "\n");
+
+	/* Serialization covers all of the graph's state, so compare that */
+	ByteWriter before;
+	ByteWriter after;
+	g.serialize(before);
+	loaded->serialize(after);
+	if (before.data() != after.data()) {
+		LOG(VerbosityLevel::Error) << "Graph changed after saving and loading it!\n"
+					   << "Saved:\n"
+					   << g << "Loaded:\n"
+					   << *loaded;
+		BUG();
+	}
+}
 #endif
 
 bool GenMCDriver::isExecutionBlocked() const
@@ -306,6 +525,9 @@ void GenMCDriver::updateStSpaceEstimation()
 	result.estimationVariance +=
 		(sample - prevM) / totalExplored * (sample - result.estimationMean) -
 		prevV / totalExplored;
+
+	if (auto *shared = std::get<EstimationMode>(mode).shared)
+		shared->addSample(sample);
 }
 
 static const auto maybeTimeRelinche = [](auto &&relinche, auto &&g) {
@@ -355,6 +577,7 @@ void GenMCDriver::handleExecutionEnd()
 		printGraph();
 
 	GENMC_DEBUG(if (getConf()->boundsHistogram && !inEstimationMode()) trackExecutionBound(););
+	GENMC_DEBUG(if (getConf()->checkGraphSerialization) checkGraphSerialization(););
 
 	++result.explored;
 	if (fullExecutionExceedsBound())
@@ -382,9 +605,16 @@ void GenMCDriver::handleExecutionEnd()
 
 bool GenMCDriver::done()
 {
+	spillDeepExecutions();
+	trackMemoryUsage();
 
+	auto *tp = getWorkPool();
 	auto validExecution = false;
 	while (!isHalting() && !validExecution) {
+		/* Share some work if other workers are starving */
+		if (tp && tp->tryClaimWorkRequest() && !donateOldestRevisit())
+			tp->unclaimWorkRequest();
+
 		auto item = getExec().getWorkqueue().getNext();
 		if (!item) {
 			if (popExecution())
@@ -398,7 +628,7 @@ bool GenMCDriver::done()
 
 bool GenMCDriver::isHalting() const
 {
-	auto *tp = getThreadPool();
+	auto *tp = getWorkPool();
 	return shouldHalt || (tp && tp->shouldHalt());
 }
 
@@ -406,8 +636,8 @@ void GenMCDriver::halt(VerificationError status)
 {
 	shouldHalt = true;
 	result.status = status;
-	if (getThreadPool())
-		getThreadPool()->halt();
+	if (getWorkPool())
+		getWorkPool()->halt();
 }
 
 /************************************************************
@@ -434,6 +664,12 @@ auto GenMCDriver::runFromCache() -> bool
 	if (!getConf()->instructionCaching || inEstimationMode())
 		return false;
 
+	/* Errors are reported by replaying the execution on the interpreter,
+	 * which cannot be done before the program has run at least once.
+	 * (Cached labels might come from some other driver.) */
+	if (!getEE()->hasRunMain())
+		return false;
+
 	do {
 		auto toAdd = getScheduler().scheduleFromCache(getExec().getGraph());
 		if (!toAdd)
@@ -1657,6 +1893,13 @@ void GenMCDriver::reportError(const ErrorDetails &details)
 	 * destroy the current execution stack */
 	auto iState = getEE()->saveState();
 
+	/* Labels added from the cache have not been seen by the interpreter
+	 * (and may have been cached by another worker), so rebuild the
+	 * interpreter's threads from the graph before replaying */
+	std::vector<ThreadInfo> tis;
+	for (auto i = 1U; i < g.getNumThreads(); i++)
+		tis.push_back(g.getFirstThreadLabel(i)->getThreadInfo());
+	getEE()->setExecutionContext(tis);
 	getEE()->replayExecutionBefore(*getReplayView());
 
 	/* Refetch ERRLAB in case it's a block label and was replaced during replay.
@@ -2296,11 +2539,13 @@ bool GenMCDriver::backwardRevisit(const BackwardRevisit &br)
 	BUG_ON(!ok);
 
 	/* If there are idle workers in the thread pool,
-	 * try submitting the job instead */
-	auto *tp = getThreadPool();
-	if (tp && tp->getRemainingTasks() < 8 * tp->size()) {
+	 * try submitting the job instead (handing off the new execution) */
+	auto *tp = getWorkPool();
+	if (tp && tp->shouldSubmit(getExec().getGraph().getMaxStamp().get())) {
 		if (isRevisitValid(br))
 			tp->submit(extractState());
+		else
+			popExecution();
 		return false;
 	}
 	return true;
@@ -2569,16 +2814,16 @@ void GenMCDriver::printGraph(bool printMetadata /* false */,
 
 	/* MO: Print coherence information */
 	auto header = false;
-	for (auto locIt = g.loc_begin(), locE = g.loc_end(); locIt != locE; ++locIt) {
+	for (const auto &loc : g.locs()) {
 		/* Skip empty and single-store locations */
-		if (g.hasLocMoreThanOneStore(locIt->first)) {
+		if (g.hasLocMoreThanOneStore(loc.addr)) {
 			if (!header) {
 				s << "Coherence:\n";
 				header = true;
 			}
-			auto *wLab = &*g.co_begin(locIt->first);
+			auto *wLab = &*g.co_begin(loc.addr);
 			s << getVarName(wLab->getAddr()) << ": [ ";
-			for (const auto &w : g.co(locIt->first))
+			for (const auto &w : g.co(loc.addr))
 				s << w << " ";
 			s << "]\n";
 		}
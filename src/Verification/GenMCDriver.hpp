@@ -20,10 +20,12 @@
 #include "ExecutionGraph/ExecutionGraph.hpp"
 #include "Support/Hash.hpp"
 #include "Support/SAddrAllocator.hpp"
+#include "Support/SpillFile.hpp"
 #include "Verification/ChoiceMap.hpp"
 #include "Verification/Relinche/LinearizabilityChecker.hpp"
 #include "Verification/Relinche/Specification.hpp"
 #include "Verification/Scheduler.hpp"
+#include "Verification/SharedEstimation.hpp"
 #include "Verification/VerificationError.hpp"
 #include "Verification/VerificationResult.hpp"
 #include "Verification/WorkList.hpp"
@@ -43,6 +45,9 @@ class Interpreter;
 }
 class ModuleInfo;
 class ThreadPool;
+class WorkPool;
+class DistributedWorker;
+class MessageChannel;
 class BoundDecider;
 class ConsistencyChecker;
 class SymmetryChecker;
@@ -58,6 +63,7 @@ public:
 	struct VerificationMode {};
 	struct EstimationMode {
 		unsigned int budget;
+		SharedEstimation *shared = nullptr; /**< Set when estimating in parallel */
 	};
 	using Mode = std::variant<VerificationMode, EstimationMode>;
 
@@ -91,6 +97,14 @@ public:
 		/** Removes all items with stamp >= STAMP from the execution */
 		void restrict(Stamp stamp);
 
+		/** Writes the execution in a binary format */
+		void serialize(ByteWriter &out) const;
+
+		/** Reads an execution written by serialize(). The graph will
+		 * use F to obtain the initial values of memory locations */
+		static auto deserialize(ByteReader &in, ExecutionGraph::InitValGetter f)
+			-> std::unique_ptr<Execution>;
+
 		~Execution();
 
 		std::unique_ptr<ExecutionGraph> graph;
@@ -98,6 +112,18 @@ public:
 		ChoiceMap choices;
 		SAddrAllocator alloctor;
 		Event lastAdded = Event::getInit();
+
+		/** The position of the execution in the tree of submitted tasks
+		 * (only set by pools that need stable task IDs) */
+		std::vector<unsigned int> taskId;
+
+		/** The (estimated) bytes the execution holds while it waits in
+		 * a pool's queue (only set if memory usage is tracked) */
+		std::size_t queuedBytes = 0;
+
+		/** Where the graph, choices, and allocator have been spilled to
+		 * (if they have). The workqueue always remains in memory */
+		std::optional<SpillFile::Record> spilled;
 	};
 
 	/** Details for an error to be reported */
@@ -141,6 +167,16 @@ public:
 	const VerificationResult &getResult() const { return result; }
 	VerificationResult &getResult() { return result; }
 
+	/** Returns the result gathered so far and starts gathering anew.
+	 * (Any collected specification stays with the driver.) */
+	auto takeResult() -> VerificationResult
+	{
+		VerificationResult res;
+		std::swap(res, result);
+		result.specification = std::move(res.specification);
+		return res;
+	}
+
 	/*** Instruction handling ***/
 
 	/** A thread has just finished execution, nothing for the interpreter */
@@ -207,14 +243,20 @@ protected:
 	friend class Scheduler;
 	friend class ArbitraryScheduler;
 	friend class ThreadPool;
+	friend class DistributedWorker;
 	friend void run(GenMCDriver *driver, llvm::Interpreter *EE);
+	friend void runDistributedWorker(std::shared_ptr<const Config> conf,
+					 std::unique_ptr<MessageChannel> ch,
+					 std::unique_ptr<llvm::Module> mod,
+					 std::unique_ptr<ModuleInfo> modInfo, bool isFirst);
 	friend auto estimate(std::shared_ptr<const Config> conf,
 			     const std::unique_ptr<llvm::Module> &mod,
-			     const std::unique_ptr<ModuleInfo> &modInfo) -> VerificationResult;
+			     const std::unique_ptr<ModuleInfo> &modInfo, SharedEstimation *shared)
+		-> VerificationResult;
 	friend auto verify(std::shared_ptr<const Config> conf, std::unique_ptr<llvm::Module> mod,
 			   std::unique_ptr<ModuleInfo> modInfo) -> VerificationResult;
 
-	GenMCDriver(std::shared_ptr<const Config> conf, ThreadPool *pool = nullptr,
+	GenMCDriver(std::shared_ptr<const Config> conf, WorkPool *pool = nullptr,
 		    Mode = VerificationMode{});
 
 	/** No copying or copy-assignment of this class is allowed */
@@ -259,18 +301,42 @@ protected:
 	 * Returns false if the stack is empty or this was the last entry. */
 	bool popExecution();
 
-	/** Gets/sets the thread pool this driver should account to */
-	ThreadPool *getThreadPool() { return pool; }
-	ThreadPool *getThreadPool() const { return pool; }
-	void setThreadPool(ThreadPool *tp) { pool = tp; }
+	/** Spill: Spills all stack entries below the top ones that
+	 * should remain in memory. Should be called between executions */
+	void spillDeepExecutions();
+
+	/** Spill: Moves the bulk of EXEC (which must not be the current
+	 * execution) to the spill file */
+	void spillExecution(Execution &exec);
+
+	/** Spill: Reads back the spilled data of EXEC. If RELEASE holds,
+	 * the data are also dropped from the spill file (along with any
+	 * data spilled later) */
+	void reloadExecution(Execution &exec, bool release = true);
+
+	/** Gets/sets the work pool this driver should account to */
+	WorkPool *getWorkPool() { return pool; }
+	WorkPool *getWorkPool() const { return pool; }
+	void setWorkPool(WorkPool *wp) { pool = wp; }
 
 	/** Initializes the exploration from a given state */
 	void initFromState(std::unique_ptr<Execution> s);
 
-	/** Extracts the current driver state.
-	 * The driver is left in an inconsistent form */
+	/** Extracts the current driver state by moving the top execution
+	 * out of the stack. There needs to be at least another execution
+	 * in the stack, which becomes the current one */
 	std::unique_ptr<Execution> extractState();
 
+	/** Parallel: Submits the oldest pending revisit (along with the
+	 * respective execution) to the thread pool.
+	 * Returns false if there is not enough work to share */
+	bool donateOldestRevisit();
+
+	/** Periodically samples the memory used by the exploration (for the
+	 * statistics), and tries to reduce it if it exceeds the user's limit.
+	 * Should be called between executions */
+	void trackMemoryUsage();
+
 	/** Returns the value that a read is reading. This function should be
 	 * used when calculating the value that we should return to the
 	 * interpreter. */
@@ -283,6 +349,9 @@ protected:
 	/** Est: Returns true if the estimation seems "good enough" */
 	bool shouldStopEstimating()
 	{
+		if (auto *shared = std::get<EstimationMode>(mode).shared)
+			return shared->isDone();
+
 		auto remainingBudget = --std::get<EstimationMode>(mode).budget;
 		if (remainingBudget == 0)
 			return true;
@@ -442,7 +511,9 @@ private:
 	auto completeRevisitedRMW(const ReadLabel *rLab) -> WriteLabel *;
 
 	/** Copies the current EG according to BR's view V.
-	 * May modify V but will not execute BR in the copy. */
+	 * May modify V but will not execute BR in the copy.
+	 * (The copy shares nothing with the current EG: labels are linked
+	 * into the lists of their graph and point back to it) */
 	std::unique_ptr<ExecutionGraph> copyGraph(const BackwardRevisit *br, VectorClock *v) const;
 
 	/** Given a list of stores that it is consistent to read-from,
@@ -530,6 +601,10 @@ private:
 #ifdef ENABLE_GENMC_DEBUG
 	/** Update bounds histogram with the current, complete execution */
 	void trackExecutionBound();
+
+	/** Saves the current graph to a file and loads it back,
+	 * checking that the loaded graph is the same */
+	void checkGraphSerialization();
 #endif
 
 	/*** Output-related ***/
@@ -584,8 +659,8 @@ private:
 	/** The operating mode of the driver */
 	Mode mode = VerificationMode{};
 
-	/** The thread pool this driver may belong to */
-	ThreadPool *pool = nullptr;
+	/** The work pool this driver may belong to */
+	WorkPool *pool = nullptr;
 
 	/** User configuration */
 	std::shared_ptr<const Config> userConf;
@@ -596,6 +671,10 @@ private:
 	/** Execution stack */
 	std::vector<Execution> execStack;
 
+	/** Spill: Where the entries deep in the execution stack are spilled to.
+	 * Entries are spilled bottom-up, so records are released in LIFO order */
+	SpillFile spillFile;
+
 	/** Scheduler */
 	std::unique_ptr<Scheduler> scheduler_;
 
@@ -620,6 +699,9 @@ private:
 	/** Whether we are stopping the exploration (e.g., due to an error found) */
 	bool shouldHalt = false;
 
+	/** Number of times trackMemoryUsage() has been called */
+	unsigned int memoryTrackingCalls = 0;
+
 	/** Dbg: Random-number generators for estimation randomization */
 	MyRNG estRng;
 };
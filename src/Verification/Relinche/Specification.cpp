@@ -97,6 +97,22 @@ void Specification::merge(Specification &&other)
 	}
 }
 
+auto Specification::getMemoryUsage() const -> std::size_t
+{
+	auto size = data_.bucket_count() * sizeof(void *);
+	for (const auto &[obs, rec] : data_) {
+		size += sizeof(storage_t::value_type) + obs.getNumOps() * sizeof(MethodCall) +
+			obs.rfs().size() * sizeof(std::pair<int, int>) +
+			obs.hb().size() * sizeof(Observation::CallEdge);
+		for (const auto &lin : rec.lins)
+			size += sizeof(Linearization) +
+				lin.size() * (sizeof(MethodCall::Id) + sizeof(unsigned));
+		for (const auto &hint : rec.hints)
+			size += sizeof(Hint) + hint.edges.size() * sizeof(Observation::CallEdge);
+	}
+	return size;
+}
+
 /*******************************************************************************
  **                     Observation addition utilities
  ******************************************************************************/
@@ -119,6 +119,9 @@ public:
 	void merge(Specification &&other);
 	void calculateHints();
 
+	/** Returns an estimate of the bytes held by the specification */
+	[[nodiscard]] auto getMemoryUsage() const -> std::size_t;
+
 private:
 	using storage_t = std::unordered_multimap<Observation, Record>;
 
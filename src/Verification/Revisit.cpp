@@ -12,6 +12,7 @@
  */
 
 #include "Revisit.hpp"
+#include "Support/Serialization.hpp"
 
 llvm::raw_ostream &operator<<(llvm::raw_ostream &s, const Revisit::Kind k)
 {
@@ -68,3 +69,56 @@ llvm::raw_ostream &operator<<(llvm::raw_ostream &s, const Revisit &item)
 	}
 	return s;
 }
+
+void Revisit::serialize(ByteWriter &out) const
+{
+	out.writeEnum(getKind());
+	getPos().serialize(out);
+	switch (getKind()) {
+	case Revisit::RV_FRevRead: {
+		auto &fi = static_cast<const ReadForwardRevisit &>(*this);
+		fi.getRev().serialize(out);
+		out.writeBool(fi.isMaximal());
+		break;
+	}
+	case Revisit::RV_FRevMO:
+		static_cast<const WriteForwardRevisit &>(*this).getPred().serialize(out);
+		break;
+	case Revisit::RV_FRevOpt:
+	case Revisit::RV_FRevRerun:
+		break;
+	case Revisit::RV_BRev: {
+		auto &bi = static_cast<const BackwardRevisit &>(*this);
+		bi.getRev().serialize(out);
+		bi.getViewNoRel()->serialize(out);
+		break;
+	}
+	default:
+		BUG();
+	}
+}
+
+std::unique_ptr<Revisit> Revisit::deserialize(ByteReader &in)
+{
+	auto kind = in.readEnum<Revisit::Kind>();
+	auto pos = Event::deserialize(in);
+	switch (kind) {
+	case Revisit::RV_FRevRead: {
+		auto rev = Event::deserialize(in);
+		auto maximal = in.readBool();
+		return std::make_unique<ReadForwardRevisit>(pos, rev, maximal);
+	}
+	case Revisit::RV_FRevMO:
+		return std::make_unique<WriteForwardRevisit>(pos, Event::deserialize(in));
+	case Revisit::RV_FRevOpt:
+		return std::make_unique<OptionalForwardRevisit>(pos);
+	case Revisit::RV_FRevRerun:
+		return std::make_unique<RerunForwardRevisit>();
+	case Revisit::RV_BRev: {
+		auto rev = Event::deserialize(in);
+		return std::make_unique<BackwardRevisit>(pos, rev, VectorClock::deserialize(in));
+	}
+	default:
+		ERROR("Malformed serialized revisit!\n");
+	}
+}
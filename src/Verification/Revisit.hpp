@@ -17,6 +17,8 @@
 #include "ExecutionGraph/EventLabel.hpp"
 
 class ReadRevisit;
+class ByteWriter;
+class ByteReader;
 
 /** Abstract class representing a revisit operation */
 class Revisit {
@@ -53,6 +55,10 @@ public:
 
 	/** Destructor and printing facilities */
 	virtual ~Revisit() {}
+
+	/** Serialization facilities (see Support/Serialization.hpp) */
+	void serialize(ByteWriter &out) const;
+	static std::unique_ptr<Revisit> deserialize(ByteReader &in);
 	friend llvm::raw_ostream &operator<<(llvm::raw_ostream &rhs, const Revisit &item);
 
 private:
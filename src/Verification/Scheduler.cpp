@@ -243,6 +243,11 @@ void Scheduler::cacheEventLabel(const ExecutionGraph &g, const EventLabel *lab)
 
 	/* Extract value prefix and find how much of it has already been cached */
 	auto [vals, indices] = extractValPrefix(g, lab->getPos());
+	if (sharedCache_) {
+		const auto *shared = sharedCache_->lookup(cacheKey, vals);
+		if (shared && !shared->empty() && shared->back()->getIndex() >= lab->getIndex())
+			return;
+	}
 	auto commonPrefixLen = seenPrefixes[cacheKey].findLongestCommonPrefix(vals);
 	std::vector<SVal> seenVals(vals.begin(), vals.begin() + commonPrefixLen);
 	auto *data = retrieveCachedSuccessors(cacheKey, seenVals);
@@ -277,7 +282,13 @@ void Scheduler::cacheEventLabel(const ExecutionGraph &g, const EventLabel *lab)
 			BUG_ON(!res);
 			data = retrieveCachedSuccessors(cacheKey, seenVals);
 		}
+		cachedBytes_ += labs[i]->getFootprint();
 		data->push_back(std::move(labs[i]));
+
+		/* Nothing will be appended to complete sequences; share them */
+		if (sharedCache_ && (data->back()->returnsValue() ||
+				     llvm::isa<ThreadFinishLabel>(&*data->back())))
+			sharedCache_->publish(cacheKey, seenVals, *data);
 	}
 }
 
@@ -291,21 +302,27 @@ static auto findNextLabelToAdd(const ExecutionGraph &g, int thread) -> Event
 }
 
 auto Scheduler::retrieveFromCache(const ExecutionGraph &g, int thread)
-	-> std::vector<std::unique_ptr<EventLabel>> *
+	-> const std::vector<std::unique_ptr<EventLabel>> *
 {
 	auto key = std::make_pair(g.getFirstThreadLabel(thread)->getThreadInfo().funId,
 				  (unsigned)thread);
 
 	auto next = findNextLabelToAdd(g, thread);
 	auto [vals, last] = extractValPrefix(g, next);
-	auto *res = retrieveCachedSuccessors(key, vals);
-	if (res == nullptr || res->empty() || res->back()->getIndex() < next.index)
-		return nullptr;
-	return res;
+	auto covers = [&](auto *labs) {
+		return labs != nullptr && !labs->empty() && labs->back()->getIndex() >= next.index;
+	};
+
+	const auto *res = retrieveCachedSuccessors(key, vals);
+	if (covers(res))
+		return res;
+	if (sharedCache_ && covers(res = sharedCache_->lookup(key, vals)))
+		return res;
+	return nullptr;
 }
 
 auto Scheduler::scheduleFromCache(ExecutionGraph &g)
-	-> std::optional<std::vector<std::unique_ptr<EventLabel>> *>
+	-> std::optional<const std::vector<std::unique_ptr<EventLabel>> *>
 {
 	auto tids = g.thr_ids();
 	auto nextIt = std::ranges::find_if(tids, [&](auto tid) { return isSchedulable(g, tid); });
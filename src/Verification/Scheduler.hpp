@@ -17,6 +17,7 @@
 #include "ADT/Trie.hpp"
 #include "ExecutionGraph/ExecutionGraph.hpp"
 #include "Runtime/InterpreterEnumAPI.hpp"
+#include "Verification/SharedLabelCache.hpp"
 
 #include <optional>
 #include <random>
@@ -51,7 +52,22 @@ public:
 	/** Returns the next labels to add by inspecting the cache. If the execution is full,
 	 * returns nullopt. If no cached information exists, returns Some(nullptr) */
 	[[nodiscard]] auto scheduleFromCache(ExecutionGraph &g)
-		-> std::optional<std::vector<std::unique_ptr<EventLabel>> *>;
+		-> std::optional<const std::vector<std::unique_ptr<EventLabel>> *>;
+
+	/** Opt: Returns an estimate of the bytes held by the (local) cache */
+	[[nodiscard]] auto getCacheMemoryUsage() const -> std::size_t { return cachedBytes_; }
+
+	/** Opt: Drops all cached labels (e.g., to reduce memory usage).
+	 * Should not be called while labels from the cache are being added */
+	void clearCache()
+	{
+		seenPrefixes.clear();
+		cachedBytes_ = 0;
+	}
+
+	/** Opt: Sets a cache shared with other schedulers, which is consulted
+	 * when the local one misses, and to which complete sequences are published */
+	void setSharedCache(SharedLabelCache *cache) { sharedCache_ = cache; }
 
 	/** Opt: Whether the exploration should try to repair R */
 	[[nodiscard]] auto isRescheduledRead(Event r) const -> bool
@@ -76,7 +92,7 @@ private:
 	/** Opt: Retrieves the next labels to add for THREAD from the cache.
 	 * Returns nullptr if no cached info exists. */
 	auto retrieveFromCache(const ExecutionGraph &g, int thread)
-		-> std::vector<std::unique_ptr<EventLabel>> *;
+		-> const std::vector<std::unique_ptr<EventLabel>> *;
 
 	/** Opt: Checks whether SEQ has been seen before for <FUN_ID, TID> and
 	 * if so returns its successors. Returns nullptr otherwise. */
@@ -116,6 +132,12 @@ private:
 
 	/** Opt: Cached labels for optimized scheduling */
 	ValuePrefixT seenPrefixes;
+
+	/** Opt: (Approximate) bytes held by the cached labels */
+	std::size_t cachedBytes_ = 0;
+
+	/** Opt: Cached labels shared with other schedulers (if any) */
+	SharedLabelCache *sharedCache_ = nullptr;
 };
 
 class ArbitraryScheduler : public Scheduler {
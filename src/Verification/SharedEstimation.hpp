@@ -0,0 +1,73 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#ifndef GENMC_SHARED_ESTIMATION_HPP
+#define GENMC_SHARED_ESTIMATION_HPP
+
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+/**
+ * State-space estimation statistics shared among drivers that estimate in
+ * parallel. The drivers feed their samples here, so that the stopping
+ * criterion is evaluated on all samples collected so far.
+ */
+class SharedEstimation {
+
+public:
+	SharedEstimation(unsigned int budget, unsigned int minSamples, unsigned int sdThreshold)
+		: budget_(budget), minSamples_(minSamples), sdThreshold_(sdThreshold)
+	{}
+
+	SharedEstimation(const SharedEstimation &) = delete;
+	auto operator=(const SharedEstimation &) -> SharedEstimation & = delete;
+
+	/** Accounts for a new sample (Welford's online algorithm), and
+	 * checks whether the estimation seems "good enough" */
+	void addSample(long double sample)
+	{
+		std::lock_guard<std::mutex> lock(mtx_);
+		if (done_.load())
+			return;
+
+		++samples_;
+		auto delta = sample - mean_;
+		mean_ += delta / samples_;
+		m2_ += delta * (sample - mean_);
+
+		/* Same criterion as GenMCDriver::shouldStopEstimating(), which
+		 * runs before the current sample is counted as explored */
+		auto explored = samples_ - 1;
+		auto sd = std::sqrt(m2_ / samples_);
+		if (samples_ >= budget_ ||
+		    (explored >= minSamples_ && (sd <= mean_ / sdThreshold_ || explored > mean_)))
+			done_.store(true);
+	}
+
+	/** Whether all drivers should stop estimating */
+	[[nodiscard]] auto isDone() const -> bool { return done_.load(); }
+
+private:
+	const unsigned int budget_;
+	const unsigned int minSamples_;
+	const unsigned int sdThreshold_;
+
+	std::mutex mtx_;
+	unsigned int samples_ = 0;
+	long double mean_ = 0;
+	long double m2_ = 0;
+	std::atomic<bool> done_{false};
+};
+
+#endif /* GENMC_SHARED_ESTIMATION_HPP */
@@ -0,0 +1,92 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#include "SharedLabelCache.hpp"
+#include "Support/Hash.hpp"
+
+auto SharedLabelCache::hash(KeyT key, const std::vector<SVal> &vals) -> std::size_t
+{
+	std::size_t seed = 0;
+	hash_combine(seed, key.first);
+	hash_combine(seed, key.second);
+	for (const auto &v : vals)
+		hash_combine(seed, v.get());
+	return seed;
+}
+
+auto SharedLabelCache::find(const Entry *head, KeyT key, const std::vector<SVal> &vals)
+	-> const Entry *
+{
+	for (const auto *e = head; e; e = e->next) {
+		if (e->key == key && e->vals == vals)
+			return e;
+	}
+	return nullptr;
+}
+
+auto SharedLabelCache::lookup(KeyT key, const std::vector<SVal> &vals) const -> const LabelsT *
+{
+	const auto &bucket = buckets_[hash(key, vals) % numBuckets];
+	const auto *e = find(bucket.load(std::memory_order_acquire), key, vals);
+	return e ? &e->labs : nullptr;
+}
+
+auto SharedLabelCache::publish(KeyT key, const std::vector<SVal> &vals, const LabelsT &labs)
+	-> bool
+{
+	if (isFrozen())
+		return false;
+
+	auto &bucket = buckets_[hash(key, vals) % numBuckets];
+	auto *head = bucket.load(std::memory_order_acquire);
+	if (find(head, key, vals))
+		return false;
+
+	auto entry = std::make_unique<Entry>();
+	entry->key = key;
+	entry->vals = vals;
+	for (const auto &lab : labs)
+		entry->labs.push_back(lab->clone());
+
+	/* Only the entries that got in since the last check need to be
+	 * checked for duplicates on a failed CAS */
+	auto *checked = head;
+	entry->next = head;
+	while (!bucket.compare_exchange_weak(entry->next, &*entry, std::memory_order_release,
+					     std::memory_order_acquire)) {
+		for (const auto *e = entry->next; e != checked; e = e->next) {
+			if (e->key == key && e->vals == vals)
+				return false;
+		}
+		checked = entry->next;
+	}
+	auto bytes = sizeof(Entry) + vals.size() * sizeof(SVal);
+	for (const auto &lab : entry->labs)
+		bytes += lab->getFootprint();
+	bytes_.fetch_add(bytes, std::memory_order_relaxed);
+	entries_.fetch_add(1, std::memory_order_relaxed);
+	entry.release();
+	return true;
+}
+
+SharedLabelCache::~SharedLabelCache()
+{
+	for (auto &bucket : buckets_) {
+		auto *e = bucket.load(std::memory_order_relaxed);
+		while (e) {
+			auto *next = e->next;
+			delete e;
+			e = next;
+		}
+	}
+}
@@ -0,0 +1,120 @@
+/*
+ * GenMC -- Generic Model Checking.
+ *
+ * This project is dual-licensed under the Apache License 2.0 and the MIT License.
+ * You may choose to use, distribute, or modify this software under either license.
+ *
+ * Apache License 2.0:
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * MIT License:
+ *     https://opensource.org/licenses/MIT
+ */
+
+#ifndef GENMC_SHARED_LABEL_CACHE_HPP
+#define GENMC_SHARED_LABEL_CACHE_HPP
+
+#include "ExecutionGraph/EventLabel.hpp"
+#include "Support/SVal.hpp"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/*******************************************************************************
+ **                        SharedLabelCache Class
+ ******************************************************************************/
+
+/**
+ * An instruction cache shared among the drivers of a thread pool.
+ * Like the schedulers' local caches, it maps a thread (<fun_id, tid>) and
+ * the values it has read so far to the labels it adds next. Only complete
+ * sequences (i.e., ones that end with a label returning a value, or with
+ * the thread's end) are published, so entries are immutable: lookups
+ * are lock-free, and insertions only need a CAS.
+ * Entries are never removed (lookups may be holding on to them); instead,
+ * publishing stops once the cache holds more than its budget of bytes, or
+ * once it is frozen.
+ */
+class SharedLabelCache {
+
+public:
+	using KeyT = std::pair<unsigned int, unsigned int>; // fun_id, tid
+	using LabelsT = std::vector<std::unique_ptr<EventLabel>>;
+
+	/** By default, the cache stops growing after 256MB */
+	static constexpr std::size_t defaultBudget = std::size_t(256) << 20U;
+
+	explicit SharedLabelCache(std::size_t budget = defaultBudget)
+		: buckets_(numBuckets), budget_(budget)
+	{}
+
+	SharedLabelCache(const SharedLabelCache &) = delete;
+	auto operator=(const SharedLabelCache &) -> SharedLabelCache & = delete;
+
+	/** Returns the labels that follow VALS for KEY, or nullptr if
+	 * no such labels have been published */
+	[[nodiscard]] auto lookup(KeyT key, const std::vector<SVal> &vals) const -> const LabelsT *;
+
+	/** Publishes (copies of) LABS as the complete sequence that follows
+	 * VALS for KEY. Returns false if some sequence was already published */
+	auto publish(KeyT key, const std::vector<SVal> &vals, const LabelsT &labs) -> bool;
+
+	/** Returns an estimate of the bytes held by the cache */
+	[[nodiscard]] auto getMemoryUsage() const -> std::size_t
+	{
+		return bytes_.load(std::memory_order_relaxed);
+	}
+
+	/** Returns the number of sequences published */
+	[[nodiscard]] auto getNumEntries() const -> std::size_t
+	{
+		return entries_.load(std::memory_order_relaxed);
+	}
+
+	/** Stops publishing new sequences (e.g., to bound memory usage) */
+	void freeze() { frozen_.store(true, std::memory_order_relaxed); }
+
+	/** Returns true if no more sequences are published */
+	[[nodiscard]] auto isFrozen() const -> bool
+	{
+		return frozen_.load(std::memory_order_relaxed) || getMemoryUsage() >= budget_;
+	}
+
+	~SharedLabelCache();
+
+private:
+	struct Entry {
+		KeyT key;
+		std::vector<SVal> vals;
+		LabelsT labs;
+		Entry *next = nullptr;
+	};
+
+	static constexpr std::size_t numBuckets = 1U << 14;
+
+	[[nodiscard]] static auto hash(KeyT key, const std::vector<SVal> &vals) -> std::size_t;
+
+	/** Returns the entry for KEY and VALS in the chain starting at HEAD (if any) */
+	[[nodiscard]] static auto find(const Entry *head, KeyT key, const std::vector<SVal> &vals)
+		-> const Entry *;
+
+	/** Hash buckets, each pointing to a chain of entries. New entries
+	 * are prepended; the rest of a chain is never modified */
+	std::vector<std::atomic<Entry *>> buckets_;
+
+	/** (Approximate) bytes held by the entries */
+	std::atomic<std::size_t> bytes_{0};
+
+	/** Number of entries */
+	std::atomic<std::size_t> entries_{0};
+
+	/** Bytes after which nothing more is published. (Concurrent
+	 * publishers may overshoot it by a few entries) */
+	std::size_t budget_;
+
+	std::atomic<bool> frozen_{false};
+};
+
+#endif /* GENMC_SHARED_LABEL_CACHE_HPP */
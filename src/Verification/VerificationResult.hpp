@@ -2,13 +2,17 @@
 #define GENMC_VERIFICATION_RESULT_HPP
 
 #include "ADT/VSet.hpp"
+#include "Support/Serialization.hpp"
 #include "Verification/Relinche/LinearizabilityChecker.hpp"
 #include "Verification/Relinche/Specification.hpp"
 #include "Verification/VerificationError.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 struct VerificationResult {
 	VerificationError status = VerificationError::VE_OK; /**< Whether the verification
@@ -18,6 +22,21 @@ struct VerificationResult {
 	unsigned boundExceeding{};	  /**< Number of bound-exceeding executions explored */
 	long double estimationMean{};	  /**< The mean of estimations */
 	long double estimationVariance{}; /**< The (biased) variance of the estimations */
+	unsigned tasksSubmitted{};	  /**< Number of tasks submitted to the thread pool */
+	unsigned tasksDonated{};	  /**< Number of tasks donated to idle threads */
+	unsigned tasksStolen{};		  /**< Number of tasks stolen by idle threads */
+	unsigned tasksStolenRemote{};	  /**< Number of tasks stolen across NUMA nodes */
+	std::vector<std::pair<std::chrono::steady_clock::duration,
+			      std::chrono::steady_clock::duration>>
+		workerTimes; /**< Busy/idle time of each thread */
+	std::size_t peakGraphMemory{}; /**< Peak (sampled) bytes used by the graphs on the stack */
+	std::size_t peakCacheMemory{}; /**< Peak (sampled) bytes used by the instruction cache */
+	std::size_t peakSpecMemory{};  /**< Peak (sampled) bytes used by the collected spec */
+	std::size_t peakPoolMemory{};  /**< Peak (sampled) share of the bytes held by the pool */
+	unsigned peakStackDepth{};     /**< Peak (sampled) depth of the execution stack */
+	std::size_t sharedCacheMemory{}; /**< Bytes held by the pool's shared instruction cache */
+	std::size_t sharedCacheEntries{}; /**< Sequences in the pool's shared instruction cache */
+	unsigned memoryMitigations{};  /**< Number of times the memory limit was exceeded */
 #ifdef ENABLE_GENMC_DEBUG
 	unsigned exploredMoot{};		/**< Number of moot executions _encountered_ */
 	unsigned duplicates{};			/**< Number of duplicate executions explored */
@@ -37,11 +56,37 @@ struct VerificationResult {
 		if (other.status != VerificationError::VE_OK)
 			status = other.status;
 		message += other.message;
+
+		/* Merge the estimations (Chan et al.'s parallel variant of Welford's
+		 * algorithm); the estimations are over explored+blocked samples */
+		auto n1 = (long double)explored + exploredBlocked;
+		auto n2 = (long double)other.explored + other.exploredBlocked;
+		if (n1 + n2 > 0) {
+			auto delta = other.estimationMean - estimationMean;
+			auto n = n1 + n2;
+			estimationVariance = (n1 * estimationVariance +
+					      n2 * other.estimationVariance +
+					      delta * delta * n1 * n2 / n) /
+					     n;
+			estimationMean += delta * n2 / n;
+		}
+
 		explored += other.explored;
 		exploredBlocked += other.exploredBlocked;
 		boundExceeding += other.boundExceeding;
-		estimationMean += other.estimationMean;
-		estimationVariance += other.estimationVariance;
+		tasksSubmitted += other.tasksSubmitted;
+		tasksDonated += other.tasksDonated;
+		tasksStolen += other.tasksStolen;
+		tasksStolenRemote += other.tasksStolenRemote;
+		/* Workers run concurrently, so their peaks may add up */
+		peakGraphMemory += other.peakGraphMemory;
+		peakCacheMemory += other.peakCacheMemory;
+		peakSpecMemory += other.peakSpecMemory;
+		peakPoolMemory += other.peakPoolMemory;
+		peakStackDepth = std::max(peakStackDepth, other.peakStackDepth);
+		sharedCacheMemory += other.sharedCacheMemory;
+		sharedCacheEntries += other.sharedCacheEntries;
+		memoryMitigations += other.memoryMitigations;
 #ifdef ENABLE_GENMC_DEBUG
 		exploredMoot += other.exploredMoot;
 		/* Bound-blocked executions are calculated at the end */
@@ -57,6 +102,101 @@ struct VerificationResult {
 		relincheResult += std::move(other.relincheResult);
 		return *this;
 	}
+
+	/** Folds the peaks of OTHER, a later task run by the same worker, into
+	 * this result's (the worker's peak is the largest of its tasks'), and
+	 * clears them in OTHER, so that adding OTHER does not count them again */
+	void takePeaks(VerificationResult &other)
+	{
+		peakGraphMemory = std::max(peakGraphMemory, other.peakGraphMemory);
+		peakCacheMemory = std::max(peakCacheMemory, other.peakCacheMemory);
+		peakSpecMemory = std::max(peakSpecMemory, other.peakSpecMemory);
+		peakPoolMemory = std::max(peakPoolMemory, other.peakPoolMemory);
+		peakStackDepth = std::max(peakStackDepth, other.peakStackDepth);
+		other.peakGraphMemory = other.peakCacheMemory = other.peakSpecMemory =
+			other.peakPoolMemory = other.peakStackDepth = 0;
+	}
+
+	/** Writes the result in a binary format. Specifications and
+	 * Relinche results are not serialized */
+	void serialize(ByteWriter &out) const
+	{
+		out.writeEnum(status);
+		out.writeU64(explored);
+		out.writeU64(exploredBlocked);
+		out.writeU64(boundExceeding);
+		out.writeU64(tasksSubmitted);
+		out.writeU64(tasksDonated);
+		out.writeU64(tasksStolen);
+		out.writeU64(tasksStolenRemote);
+		out.writeU64(peakGraphMemory);
+		out.writeU64(peakCacheMemory);
+		out.writeU64(peakSpecMemory);
+		out.writeU64(peakPoolMemory);
+		out.writeU64(peakStackDepth);
+		out.writeU64(sharedCacheMemory);
+		out.writeU64(sharedCacheEntries);
+		out.writeU64(memoryMitigations);
+		out.writeU64(workerTimes.size());
+		for (const auto &[busy, idle] : workerTimes) {
+			out.writeS64(busy.count());
+			out.writeS64(idle.count());
+		}
+#ifdef ENABLE_GENMC_DEBUG
+		out.writeU64(exploredMoot);
+		out.writeU64(duplicates);
+		out.writeU64(exploredBounds.size());
+		for (auto i = 0U; i < exploredBounds.size(); i++)
+			out.writeS64(exploredBounds[i]);
+#endif
+		out.writeString(message);
+		out.writeU64(warnings.size());
+		for (const auto &w : warnings)
+			out.writeEnum(w);
+	}
+
+	static auto deserialize(ByteReader &in) -> VerificationResult
+	{
+		using DurationT = std::chrono::steady_clock::duration;
+
+		VerificationResult res;
+		res.status = in.readEnum<VerificationError>();
+		res.explored = in.readU64();
+		res.exploredBlocked = in.readU64();
+		res.boundExceeding = in.readU64();
+		res.tasksSubmitted = in.readU64();
+		res.tasksDonated = in.readU64();
+		res.tasksStolen = in.readU64();
+		res.tasksStolenRemote = in.readU64();
+		res.peakGraphMemory = in.readU64();
+		res.peakCacheMemory = in.readU64();
+		res.peakSpecMemory = in.readU64();
+		res.peakPoolMemory = in.readU64();
+		res.peakStackDepth = in.readU64();
+		res.sharedCacheMemory = in.readU64();
+		res.sharedCacheEntries = in.readU64();
+		res.memoryMitigations = in.readU64();
+		auto numWorkers = in.readU64();
+		for (auto i = 0U; i < numWorkers; i++) {
+			auto busy = DurationT(in.readS64());
+			auto idle = DurationT(in.readS64());
+			res.workerTimes.emplace_back(busy, idle);
+		}
+#ifdef ENABLE_GENMC_DEBUG
+		res.exploredMoot = in.readU64();
+		res.duplicates = in.readU64();
+		auto numBounds = in.readU64();
+		if (numBounds)
+			res.exploredBounds.grow(numBounds - 1);
+		for (auto i = 0U; i < numBounds; i++)
+			res.exploredBounds[i] = in.readS64();
+#endif
+		res.message = in.readString();
+		auto numWarnings = in.readU64();
+		for (auto i = 0U; i < numWarnings; i++)
+			res.warnings.insert(in.readEnum<VerificationError>());
+		return res;
+	}
 };
 
 #endif /* GENMC_VERIFICATION_RESULT_HPP */
@@ -12,6 +12,22 @@
  */
 
 #include "WorkList.hpp"
+#include "Support/Serialization.hpp"
+
+void WorkList::serialize(ByteWriter &out) const
+{
+	out.writeU64(wlist_.size());
+	for (const auto &item : wlist_)
+		item->serialize(out);
+}
+
+auto WorkList::deserialize(ByteReader &in) -> WorkList
+{
+	WorkList result;
+	for (auto n = in.readU64(); n > 0; n--)
+		result.add(Revisit::deserialize(in));
+	return result;
+}
 
 auto operator<<(llvm::raw_ostream &s, const WorkList &wset) -> llvm::raw_ostream &
 {
@@ -31,6 +31,9 @@ public:
 	/** Returns whether this worklist is empty */
 	[[nodiscard]] auto empty() const -> bool { return wlist_.empty(); }
 
+	/** Returns the number of items in the worklist */
+	[[nodiscard]] auto size() const -> size_t { return wlist_.size(); }
+
 	/** Adds an item to the worklist */
 	void add(auto &&item) { wlist_.emplace_back(std::move(item)); }
 
@@ -45,6 +48,21 @@ public:
 		return std::move(item);
 	}
 
+	/** Returns the oldest item in the worklist (NULL if none) */
+	auto getOldest() -> ItemT
+	{
+		if (wlist_.empty())
+			return {};
+
+		auto item = std::move(wlist_.front());
+		wlist_.erase(wlist_.begin());
+		return item;
+	}
+
+	/** Serialization facilities (see Support/Serialization.hpp) */
+	void serialize(ByteWriter &out) const;
+	static auto deserialize(ByteReader &in) -> WorkList;
+
 	friend auto operator<<(llvm::raw_ostream &s, const WorkList &wlist) -> llvm::raw_ostream &;
 
 private:
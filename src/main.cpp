@@ -14,6 +14,7 @@
 #include "Config/Config.hpp"
 #include "Runtime/Interpreter.h"
 #include "Static/LLVMModule.hpp"
+#include "Support/DistributedPool.hpp"
 #include "Support/Error.hpp"
 #include "Support/ThreadPool.hpp"
 #include "Verification/GenMCDriver.hpp"
@@ -25,7 +26,9 @@
 #include <cstdio>
 #include <cstdlib>
 #include <filesystem>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <unistd.h>
 
 namespace fs = llvm::sys::fs;
@@ -314,6 +317,50 @@ static void printVerificationResults(const std::shared_ptr<const Config> &conf,
 			if (!executions)
 				PRINT(VerbosityLevel::Error) << " 0";
 		});
+	if (conf->threads > 1 && conf->printParallelStats) {
+		PRINT(VerbosityLevel::Error)
+			<< "\nNumber of parallel tasks: " << res.tasksSubmitted << " ("
+			<< res.tasksDonated << " donated, " << res.tasksStolen << " stolen)";
+	}
+	if (conf->threads > 1 && conf->printNumaStats) {
+		PRINT(VerbosityLevel::Error)
+			<< "\nNumber of tasks stolen across NUMA nodes: " << res.tasksStolenRemote;
+	}
+	if (conf->distributedWorkers > 0 && conf->printParallelStats) {
+		PRINT(VerbosityLevel::Error)
+			<< "\nNumber of distributed tasks: " << res.tasksSubmitted << " ("
+			<< res.tasksDonated << " donated)";
+	}
+	if (conf->printMemoryStats || conf->memoryLimit) {
+		auto toMB = [](std::size_t bytes) { return (double)bytes / (1U << 20U); };
+		PRINT(VerbosityLevel::Error)
+			<< llvm::format("\nPeak memory (estimated): %.2fMB graphs (stack depth %u), "
+					"%.2fMB instruction cache, %.2fMB specification",
+					toMB(res.peakGraphMemory), res.peakStackDepth,
+					toMB(res.peakCacheMemory), toMB(res.peakSpecMemory));
+		if (conf->threads > 1 || conf->distributedWorkers > 0) {
+			PRINT(VerbosityLevel::Error)
+				<< llvm::format(", %.2fMB work pool", toMB(res.peakPoolMemory));
+		}
+		if (conf->threads > 1) {
+			PRINT(VerbosityLevel::Error)
+				<< llvm::format("\nShared instruction cache: %.2fMB (%zu entries)",
+						toMB(res.sharedCacheMemory), res.sharedCacheEntries);
+		}
+		if (conf->memoryLimit) {
+			PRINT(VerbosityLevel::Error)
+				<< "\nMemory limit exceeded: " << res.memoryMitigations << " times";
+		}
+	}
+	if (conf->printParallelStats) {
+		const char *workerKind = conf->threads > 1 ? "Thread" : "Worker";
+		for (auto i = 0U; i < res.workerTimes.size(); i++) {
+			auto &[busy, idle] = res.workerTimes[i];
+			PRINT(VerbosityLevel::Error)
+				<< llvm::format("\n%s %u: %.2Lfs busy, %.2Lfs idle", workerKind,
+						i, durationToMill(busy), durationToMill(idle));
+		}
+	}
 	if (conf->checkLinSpec) {
 		PRINT(VerbosityLevel::Error)
 			<< "\nNumber of checked hints: " << res.relincheResult.hintsChecked;
@@ -369,13 +416,19 @@ void run(GenMCDriver *driver, llvm::Interpreter *EE)
 }
 
 auto estimate(std::shared_ptr<const Config> conf, const std::unique_ptr<llvm::Module> &mod,
-	      const std::unique_ptr<ModuleInfo> &modInfo) -> VerificationResult
+	      const std::unique_ptr<ModuleInfo> &modInfo, SharedEstimation *shared = nullptr)
+	-> VerificationResult
 {
+	/* The original module may be shared among parallel estimators */
+	static std::mutex cloneMtx;
+	std::unique_lock<std::mutex> lock(cloneMtx);
 	auto estCtx = std::make_unique<llvm::LLVMContext>();
 	auto newmod = LLVMModule::cloneModule(mod, estCtx);
 	auto newMI = modInfo->clone(*newmod);
-	auto driver = GenMCDriver::create(conf, nullptr,
-					  GenMCDriver::EstimationMode{conf->estimationMax});
+	lock.unlock();
+
+	auto driver = GenMCDriver::create(
+		conf, nullptr, GenMCDriver::EstimationMode{conf->estimationMax, shared});
 	std::string buf;
 	auto EE = llvm::Interpreter::create(std::move(newmod), std::move(newMI), &*driver,
 					    driver->getConf(), driver->getExec().getAllocator(),
@@ -386,9 +439,101 @@ auto estimate(std::shared_ptr<const Config> conf, const std::unique_ptr<llvm::Mo
 	return std::move(driver->getResult());
 }
 
+auto estimateParallel(std::shared_ptr<const Config> conf, const std::unique_ptr<llvm::Module> &mod,
+		      const std::unique_ptr<ModuleInfo> &modInfo) -> VerificationResult
+{
+	/* Each driver samples with its own (random) seed; all stop when the
+	 * samples gathered collectively are good enough */
+	SharedEstimation shared(conf->estimationMax, conf->estimationMin, conf->sdThreshold);
+	std::vector<std::future<VerificationResult>> results;
+	for (auto i = 0U; i < conf->threads; i++)
+		results.push_back(std::async(std::launch::async, [&] {
+			return estimate(conf, mod, modInfo, &shared);
+		}));
+
+	VerificationResult res;
+	for (auto &r : results)
+		res += r.get();
+	return res;
+}
+
+void runDistributedWorker(std::shared_ptr<const Config> conf, std::unique_ptr<MessageChannel> ch,
+			  std::unique_ptr<llvm::Module> mod, std::unique_ptr<ModuleInfo> modInfo,
+			  [[maybe_unused]] bool isFirst)
+{
+	DistributedWorker pool(std::move(ch), conf->distributedToken);
+	auto driver = GenMCDriver::create(conf, &pool, GenMCDriver::VerificationMode{});
+	std::string buf;
+	auto EE = llvm::Interpreter::create(std::move(mod), std::move(modInfo), &*driver,
+					    driver->getConf(), driver->getExec().getAllocator(),
+					    &buf);
+	driver->setEE(&*EE);
+	/* Only the first worker fails on purpose, so that others can finish */
+	GENMC_DEBUG(if (isFirst) pool.injectFaults(conf->distributedExitAfter,
+						   conf->distributedCrashAfter););
+	pool.run(&*driver, &*EE, run);
+}
+
+auto verifyDistributed(std::shared_ptr<const Config> conf, std::unique_ptr<llvm::Module> mod,
+		       std::unique_ptr<ModuleInfo> modInfo) -> VerificationResult
+{
+	DistributedCoordinator coordinator(conf);
+
+	/* Either wait for remote workers... */
+	if (conf->distributedListen) {
+		auto listener = MessageListener::listen(*conf->distributedListen);
+		ERROR_ON(!listener, "Could not listen on " << *conf->distributedListen << "!\n");
+		for (auto i = 0U; i < conf->distributedWorkers;) {
+			auto ch = listener->accept();
+			ERROR_ON(!ch, "Could not accept distributed worker!\n");
+			if (coordinator.addWorker(std::move(ch)))
+				++i;
+			else
+				WARN("Rejected a connection that is not a GenMC worker!\n");
+		}
+		return coordinator.run();
+	}
+
+	/* ... or fork local ones. Each child only keeps its own channel, so all
+	 * children are forked before the coordinator registers any channel
+	 * (otherwise, later children would keep earlier channels open) */
+	std::vector<std::pair<std::unique_ptr<MessageChannel>, std::unique_ptr<MessageChannel>>>
+		channels;
+	for (auto i = 0U; i < conf->distributedWorkers; i++) {
+		channels.push_back(MessageChannel::createPair());
+		ERROR_ON(!channels.back().first, "Could not create distributed worker channel!\n");
+	}
+	llvm::outs().flush();
+	llvm::errs().flush();
+	std::vector<pid_t> pids;
+	for (auto i = 0U; i < conf->distributedWorkers; i++) {
+		auto pid = fork();
+		ERROR_ON(pid < 0, "Could not spawn distributed worker!\n");
+		if (pid == 0) {
+			auto ch = std::move(channels[i].second);
+			channels.clear();
+			runDistributedWorker(conf, std::move(ch), std::move(mod), std::move(modInfo),
+					     i == 0);
+			/* _Exit() skips the destructors that would flush the streams */
+			llvm::outs().flush();
+			llvm::errs().flush();
+			std::_Exit(0);
+		}
+		channels[i].second.reset();
+		pids.push_back(pid);
+	}
+	for (auto i = 0U; i < conf->distributedWorkers; i++)
+		ERROR_ON(!coordinator.addWorker(std::move(channels[i].first), pids[i]),
+			 "Could not set up distributed worker!\n");
+	return coordinator.run();
+}
+
 auto verify(std::shared_ptr<const Config> conf, std::unique_ptr<llvm::Module> mod,
 	    std::unique_ptr<ModuleInfo> modInfo) -> VerificationResult
 {
+	if (conf->distributedWorkers > 0)
+		return verifyDistributed(conf, std::move(mod), std::move(modInfo));
+
 	/* Spawn a single or multiple drivers depending on the configuration */
 	if (conf->threads == 1) {
 		auto driver = GenMCDriver::create(conf, nullptr, GenMCDriver::VerificationMode{});
@@ -401,17 +546,29 @@ auto verify(std::shared_ptr<const Config> conf, std::unique_ptr<llvm::Module> mo
 		return std::move(driver->getResult());
 	}
 
-	std::vector<std::future<VerificationResult>> futures;
+	VerificationResult res;
+	ThreadPool::Stats stats;
 	{
 		/* Then, fire up the drivers */
 		ThreadPool pool(conf, mod, modInfo, run);
-		futures = pool.waitForTasks();
+		auto futures = pool.waitForTasks();
+		for (auto &f : futures) {
+			res += f.get();
+		}
+		if (conf->parallelPolicy == ParallelPolicy::Deterministic)
+			res += pool.reduceTaskResults();
+		/* All workers have returned; their times are final */
+		stats = pool.getStats();
 	}
 
-	VerificationResult res;
-	for (auto &f : futures) {
-		res += f.get();
-	}
+	res.tasksSubmitted = stats.submitted;
+	res.tasksDonated = stats.donated;
+	res.tasksStolen = stats.stolen;
+	res.tasksStolenRemote = stats.stolenRemote;
+	res.sharedCacheMemory = stats.cacheBytes;
+	res.sharedCacheEntries = stats.cacheEntries;
+	for (auto &w : stats.workers)
+		res.workerTimes.emplace_back(w.busy, w.idle);
 	return res;
 }
 
@@ -451,11 +608,21 @@ auto main(int argc, char **argv) -> int
 	transformInput(conf, *module, *modInfo);
 	PRINT(VerbosityLevel::Error) << "*** Transformation complete.\n";
 
+	/* Remote workers explore whatever the coordinator sends them */
+	if (conf->distributedConnect) {
+		auto ch = MessageChannel::connect(*conf->distributedConnect);
+		ERROR_ON(!ch, "Could not connect to " << *conf->distributedConnect << "!\n");
+		runDistributedWorker(conf, std::move(ch), std::move(module), std::move(modInfo),
+				     true);
+		return 0;
+	}
+
 	/* Estimate the state space */
 	if (conf->estimate) {
 		LOG(VerbosityLevel::Tip) << "Estimating state-space size. For better performance, "
 					    "you can use --disable-estimation.\n";
-		auto res = estimate(conf, module, modInfo);
+		auto res = conf->threads > 1 ? estimateParallel(conf, module, modInfo)
+					     : estimate(conf, module, modInfo);
 		printEstimationResults(conf, begin, res);
 		if (res.status != VerificationError::VE_OK)
 			return EVERIFY;